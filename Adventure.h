@@ -10,6 +10,7 @@
 #include <vector>
 #include <random>
 #include <ctime>
+#include <functional>
 #include <windows.h>
 #include "GameCore.h"
 #include "Shop.h"
@@ -21,7 +22,7 @@ using namespace std;
 #define MONSTER_STRUCT_DEFINED
 struct Monster {
     int id;
-    string name;
+    string_view name;  // 指向字符串池，复制怪物不会分配内存
     int hp;
     int atk;
     int exp;
@@ -58,11 +59,11 @@ struct EquipmentSlot {
 
 // 战斗统计
 struct WeaponStats {
-    string weaponName;
+    string_view weaponName;  // 武器名称来自字符串池
     int totalDamage;
     int hits;
     
-    WeaponStats(string name) : weaponName(name), totalDamage(0), hits(0) {}
+    WeaponStats(string_view name) : weaponName(name), totalDamage(0), hits(0) {}
 };
 
 // 冒险统计
@@ -75,7 +76,7 @@ struct AdventureStats {
     
     AdventureStats() : totalExpGained(0), totalExpSpent(0), enemiesDefeated(0), campfiresReached(0) {}
     
-    void addWeaponDamage(const string& weaponName, int damage) {
+    void addWeaponDamage(string_view weaponName, int damage) {
         for (auto& ws : weaponStats) {
             if (ws.weaponName == weaponName) {
                 ws.totalDamage += damage;
@@ -103,6 +104,9 @@ private:
     int difficultyLevel;  // 难度等级（经过的篝火数）
     int battlesUntilCampfire;  // 距离下一个篝火的战斗数
     Shop* campfireShop;  // 篝火商店
+    RestockClock* restockClock;  // 补货时钟（可为空，为空时每次冒险结束后刷新篝火商店）
+    function<vector<Monster>(int)> monsterSource;  // 按难度获取怪物（可为空）
+    vector<size_t> upgradedItems;  // 篝火升级成功的背包位置，冒险结束后报告给存档
     
     // 随机数生成器
     mt19937 rng;
@@ -213,6 +217,9 @@ private:
     // 单场战斗
     bool singleBattle() {
         Monster monster = getRandomMonster();
+        if (restockClock) {
+            restockClock->advance(RestockUnit::BATTLE);
+        }
         
         cout << "\n遭遇敌人：" << monster.name << "！" << endl;
         cout << "敌人属性：HP " << monster.hp << " | 攻击 " << monster.atk << " | EXP " << monster.exp << endl;
@@ -421,6 +428,7 @@ private:
                     bool success = selectedEquip->levelUp();
                     
                     if (success) {
+                        upgradedItems.push_back(static_cast<size_t>(upgradeChoice));
                         cout << "\n★ 升级成功！ ★" << endl;
                         cout << selectedEquip->getName() << " 已升级到 Lv." << selectedEquip->getLevel() << "！" << endl;
                         
@@ -454,8 +462,10 @@ private:
             return;
         }
         
-        // 如果需要刷新，刷新商店
-        if (campfireShop->isNeedsRefresh()) {
+        // 按补货时钟补货；没有时钟时按标记刷新
+        if (restockClock) {
+            campfireShop->restock(*restockClock);
+        } else if (campfireShop->isNeedsRefresh()) {
             campfireShop->refresh();
         }
         
@@ -466,7 +476,9 @@ private:
             // 计算可用EXP
             int availableExp = playerExp + stats.totalExpGained - stats.totalExpSpent;
             cout << "\n当前可用 EXP: " << availableExp << endl;
-            cout << "\n[1-3] 购买对应商品 | [4] 手动刷新 (" << campfireShop->getManualRefreshCost() << " EXP) | [0] 返回" << endl;
+            int slotCount = campfireShop->getSlotCount();
+            cout << "\n[1-" << slotCount << "] 购买对应商品 | [" << (slotCount + 1) << "] 手动刷新 ("
+                 << campfireShop->getManualRefreshCost() << " EXP) | [" << (slotCount + 2) << "] 批量购买 | [0] 返回" << endl;
             cout << ">>> 请选择: ";
             
             int choice;
@@ -474,7 +486,7 @@ private:
             
             if (choice == 0) {
                 break;
-            } else if (choice >= 1 && choice <= 3) {
+            } else if (choice >= 1 && choice <= slotCount) {
                 // 临时增加 EXP 用于购买
                 int tempExp = availableExp;
                 if (campfireShop->buyItem(choice - 1, tempExp, inventory)) {
@@ -487,7 +499,19 @@ private:
                 system("cls");
                 cout << "\n=== 篝火 - 商店 ===" << endl;
                 showAdventureStatus();
-            } else if (choice == 4) {
+            } else if (choice == slotCount + 2) {
+                // 批量购买：一次选好几件，总价一次结算，只刷新一次界面
+                vector<int> picks = Shop::readSelection(cin);
+                int tempExp = availableExp;
+                if (!picks.empty() && campfireShop->buyItems(picks, tempExp, inventory)) {
+                    stats.totalExpSpent += availableExp - tempExp;
+                    cout << "\n[提示] 装备已添加到背包！" << endl;
+                }
+                system("pause");
+                system("cls");
+                cout << "\n=== 篝火 - 商店 ===" << endl;
+                showAdventureStatus();
+            } else if (choice == slotCount + 1) {
                 // 手动刷新
                 int tempExp = availableExp;
                 if (campfireShop->manualRefresh(tempExp)) {
@@ -512,6 +536,12 @@ private:
         stats.campfiresReached++;
         difficultyLevel++;
         
+        // 难度提升后更新怪物池（内容包可能需要按需加载新的怪物）
+        if (monsterSource) {
+            vector<Monster> pool = monsterSource(difficultyLevel);
+            if (!pool.empty()) allMonsters = pool;
+        }
+        
         cout << "\n🔥 ==================== 🔥" << endl;
         cout << "     到达篝火休息点" << endl;
         cout << "🔥 ==================== 🔥" << endl;
@@ -671,9 +701,10 @@ private:
     }
 
 public:
-    AdventureSystem(vector<Monster> monsters, EquipmentSlot* equipment, int& exp, Shop* shop)
+    AdventureSystem(vector<Monster> monsters, EquipmentSlot* equipment, int& exp, Shop* shop,
+                    function<vector<Monster>(int)> source = nullptr, RestockClock* clock = nullptr)
         : allMonsters(monsters), playerEquipment(equipment), playerExp(exp),
-          difficultyLevel(0), battlesUntilCampfire(3), campfireShop(shop) {
+          difficultyLevel(0), battlesUntilCampfire(3), campfireShop(shop), restockClock(clock), monsterSource(source) {
         
         // 初始化随机数生成器
         rng.seed(static_cast<unsigned int>(time(nullptr)));
@@ -687,6 +718,11 @@ public:
         playerCurrentHp = playerMaxHp;
     }
     
+    // 本次冒险中篝火升级成功的背包位置
+    const vector<size_t>& getUpgradedItems() const {
+        return upgradedItems;
+    }
+    
     // 开始冒险
     void startAdventure(vector<Equipment*>& inventory) {
         system("cls");
@@ -779,8 +815,8 @@ public:
         }
         cout << "  当前总 EXP: " << playerExp << endl;
         
-        // 标记篝火商店需要刷新（下次冒险时刷新）
-        if (campfireShop) {
+        // 没有补货时钟时，标记篝火商店需要刷新（下次冒险时刷新）；有时钟时由调用方推进冒险次数
+        if (campfireShop && !restockClock) {
             campfireShop->markNeedsRefresh();
         }
         
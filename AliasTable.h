@@ -0,0 +1,95 @@
+/**
+ * 文件名: AliasTable.h
+ * 职责: 别名表（Vose alias method）- 按权重抽取下标，每次抽取 O(1)
+ *
+ * 构建时把各结果的概率缩放到平均为 1，概率不足 1 的格子用概率超过 1 的结果补满，
+ * 每个格子最多对应两个结果。抽取时随机选一个格子，再掷一次决定取格子本身还是它的别名。
+ * 构建 O(n)，只在权重变化时进行（例如装备模板加载完成后）。
+ */
+
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+class AliasTable {
+private:
+    vector<double> prob;      // 取格子本身的概率
+    vector<uint32_t> alias;   // 格子的另一个结果
+
+public:
+    AliasTable() = default;
+
+    explicit AliasTable(const vector<double>& weights) {
+        build(weights);
+    }
+
+    // 权重为 0 的结果永远不会被抽中；权重全为 0（或为空）时表为空
+    void build(const vector<double>& weights) {
+        prob.clear();
+        alias.clear();
+        double total = 0;
+        for (double w : weights) total += w > 0 ? w : 0;
+        if (total <= 0) return;
+
+        size_t n = weights.size();
+        prob.resize(n);
+        alias.resize(n);
+        vector<double> scaled(n);
+        vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = (weights[i] > 0 ? weights[i] : 0) * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            uint32_t l = large.back();
+            small.pop_back();
+            prob[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // 剩下的格子只差浮点误差，视为概率 1
+        for (uint32_t i : large) {
+            prob[i] = 1.0;
+            alias[i] = i;
+        }
+        for (uint32_t i : small) {
+            prob[i] = 1.0;
+            alias[i] = i;
+        }
+    }
+
+    bool empty() const {
+        return prob.empty();
+    }
+
+    size_t size() const {
+        return prob.size();
+    }
+
+    // 调用前需确认表不为空
+    template <class Rng>
+    size_t sample(Rng& rng) const {
+        uniform_int_distribution<size_t> column(0, prob.size() - 1);
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        size_t i = column(rng);
+        return coin(rng) < prob[i] ? i : alias[i];
+    }
+
+    // 由调用方给出格子（0 到 size()-1）和 [0, 1) 的小数（需要自己控制随机数来源时使用）
+    size_t sample(size_t column, double coin) const {
+        return coin < prob[column] ? column : alias[column];
+    }
+};
+
+#endif // ALIAS_TABLE_H
@@ -0,0 +1,68 @@
+/**
+ * 文件名: Checksum.h
+ * 职责: CRC32C 校验和 - 用于快速检查存档内容是否完整（只计算字节，不解析）
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <cstdio>
+
+using namespace std;
+
+class Checksum {
+private:
+    // CRC32C (Castagnoli) 反射多项式
+    static constexpr uint32_t POLY = 0x82F63B78u;
+
+    static const uint32_t* table() {
+        static const struct Table {
+            uint32_t entries[256];
+            Table() {
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++) c = (c & 1) ? (c >> 1) ^ POLY : c >> 1;
+                    entries[i] = c;
+                }
+            }
+        } instance;
+        return instance.entries;
+    }
+
+public:
+    // crc: 分段计算时传入上一段的结果
+    static uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const uint32_t* t = table();
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) {
+            crc = t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    static uint32_t crc32c(const string& data) {
+        return crc32c(data.data(), data.size());
+    }
+
+    // 分块读取整个文件计算校验和，内存占用与文件大小无关；文件不存在时返回 false
+    static bool crc32cFile(const string& path, size_t& size, uint32_t& crc) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        char buffer[64 * 1024];
+        size_t n;
+        size = 0;
+        crc = 0;
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            crc = crc32c(buffer, n, crc);
+            size += n;
+        }
+        fclose(f);
+        return true;
+    }
+};
+
+#endif // CHECKSUM_H
@@ -0,0 +1,239 @@
+/**
+ * 文件名: ContentGen.cpp
+ * 职责: 内容生成器 - 将 gamedata.json 转换为 constexpr 内容表头文件
+ *
+ * 用法: ContentGen <gamedata.json> <EmbeddedContentData.h>
+ *       ContentGen --split <gamedata.json> <输出目录>
+ * 生成的数据经过与运行时相同的校验和工厂函数，保证两条加载路径得到相同的模板。
+ * --split 把 gamedata.json 拆分为按势力的装备包和按等级的怪物包，并生成清单。
+ * 清单中每个包列出自己的全部 id（各势力的 id 是交错的，只靠 id 范围无法确定属于哪个包），
+ * 怪物包的 min_difficulty 为 0，拆包不改变各难度的怪物池。
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "json.hpp"
+#include "GameCore.h"
+#include "DataLoader.h"
+#include "DataValidator.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 把字符串转成 C++ 字符串字面量（UTF-8 原样输出，只转义特殊字符）
+static string cppLiteral(string_view s) {
+    string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default: out += c; break;
+        }
+    }
+    out += "\"";
+    return out;
+}
+
+static const char* rarityName(Rarity r) {
+    switch (r) {
+        case BROKEN: return "BROKEN";
+        case STANDARD: return "STANDARD";
+        case MILITARY: return "MILITARY";
+        case LEGENDARY: return "LEGENDARY";
+    }
+    return "BROKEN";
+}
+
+// 势力 -> 包文件名（文件名只用 ASCII，避免 Windows 下的编码问题）
+static string factionSlug(const string& faction, map<string, string>& known) {
+    auto it = known.find(faction);
+    if (it != known.end()) return it->second;
+    string slug;
+    if (faction == "共和国") slug = "republic";
+    else if (faction == "帝国") slug = "empire";
+    else if (faction == "废土") slug = "wasteland";
+    else slug = "faction" + to_string(known.size() + 1);
+    known[faction] = slug;
+    return slug;
+}
+
+static bool writeJson(const string& path, const json& j) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        cerr << "[错误] 无法写入文件: " << path << endl;
+        return false;
+    }
+    out << j.dump(4);
+    return true;
+}
+
+// 拆分为内容包：装备按势力、怪物按等级（id / 1000），保持源文件中的顺序
+static int splitContent(const json& j, const ValidationReport& report, const string& outDir) {
+    struct PackBuilder {
+        json entries = json::array();
+        int idMin = 0;
+        int idMax = 0;
+        vector<int> ids;
+    };
+    map<string, PackBuilder> equipmentPacks;  // 按势力
+    map<int, PackBuilder> monsterPacks;       // 按等级
+    vector<string> equipmentOrder;            // 势力首次出现的顺序
+    map<string, string> slugs;
+
+    auto track = [](PackBuilder& b, int id) {
+        if (b.entries.empty() || id < b.idMin) b.idMin = id;
+        if (b.entries.empty() || id > b.idMax) b.idMax = id;
+        b.ids.push_back(id);
+    };
+
+    for (size_t i = 0; i < report.equipmentValid.size(); i++) {
+        if (!report.equipmentValid[i]) continue;
+        const json& item = j["equipments"][i];
+        string faction = item["faction"];
+        if (!equipmentPacks.count(faction)) equipmentOrder.push_back(faction);
+        PackBuilder& b = equipmentPacks[faction];
+        track(b, item["id"]);
+        b.entries.push_back(item);
+    }
+
+    for (size_t i = 0; i < report.monsterValid.size(); i++) {
+        if (!report.monsterValid[i]) continue;
+        const json& item = j["monsters"][i];
+        int tier = item["id"].get<int>() / 1000;
+        PackBuilder& b = monsterPacks[tier];
+        track(b, item["id"]);
+        b.entries.push_back(item);
+    }
+
+    json manifest;
+    manifest["packs"] = json::array();
+
+    for (const string& faction : equipmentOrder) {
+        PackBuilder& b = equipmentPacks[faction];
+        string name = "equipment_" + factionSlug(faction, slugs);
+        if (!writeJson(outDir + "/" + name + ".json", json{{"equipments", b.entries}})) return 1;
+        sort(b.ids.begin(), b.ids.end());
+        manifest["packs"].push_back({
+            {"name", name}, {"kind", "equipment"}, {"file", name + ".json"},
+            {"faction", faction}, {"id_min", b.idMin}, {"id_max", b.idMax},
+            {"count", b.entries.size()}, {"ids", b.ids}
+        });
+    }
+
+    for (auto& pair : monsterPacks) {
+        PackBuilder& b = pair.second;
+        string name = "monsters_tier" + to_string(pair.first);
+        if (!writeJson(outDir + "/" + name + ".json", json{{"monsters", b.entries}})) return 1;
+        // min_difficulty 固定为 0：与 gamedata.json、内嵌内容一样，每个难度都可能遇到全部怪物，
+        // 拆包只改变加载时机（第一次冒险时才加载），不改变怪物池
+        int minDifficulty = 0;
+        sort(b.ids.begin(), b.ids.end());
+        manifest["packs"].push_back({
+            {"name", name}, {"kind", "monsters"}, {"file", name + ".json"},
+            {"tier", pair.first}, {"min_difficulty", minDifficulty},
+            {"id_min", b.idMin}, {"id_max", b.idMax}, {"count", b.entries.size()}, {"ids", b.ids}
+        });
+    }
+
+    if (!writeJson(outDir + "/manifest.json", manifest)) return 1;
+    cout << "[系统] 已生成 " << manifest["packs"].size() << " 个内容包到 " << outDir << endl;
+    return report.ok() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    bool split = argc > 1 && string(argv[1]) == "--split";
+    int argBase = split ? 2 : 1;
+    if (argc < argBase + 2) {
+        cerr << "用法: " << argv[0] << " <gamedata.json> <输出头文件>" << endl;
+        cerr << "      " << argv[0] << " --split <gamedata.json> <输出目录>" << endl;
+        return 2;
+    }
+    const char* inputFile = argv[argBase];
+    const char* outputPath = argv[argBase + 1];
+
+    ifstream in(inputFile);
+    if (!in.is_open()) {
+        cerr << "[错误] 无法打开文件: " << inputFile << endl;
+        return 1;
+    }
+
+    json j;
+    try {
+        j = json::parse(in);
+    } catch (json::parse_error& e) {
+        cerr << "[JSON错误] " << e.what() << endl;
+        return 1;
+    }
+
+    // 与运行时路径使用同一套校验规则：被拒绝的条目不会进入内嵌表或内容包
+    ValidationReport report = DataValidator::validate(j);
+    report.print(cerr);
+
+    if (split) {
+        return splitContent(j, report, outputPath);
+    }
+
+    ostringstream weapons, armors, monsters;
+    int weaponCount = 0, armorCount = 0, monsterCount = 0;
+
+    for (size_t i = 0; i < report.equipmentValid.size(); i++) {
+        if (!report.equipmentValid[i]) continue;
+        Equipment* eq = DataLoader::createEquipment(j["equipments"][i], 0);
+        if (Weapon* w = dynamic_cast<Weapon*>(eq)) {
+            weapons << "    {" << w->getId() << ", " << cppLiteral(w->getName()) << ", "
+                    << rarityName(w->getRarity()) << ", " << cppLiteral(w->getFaction()) << ", "
+                    << w->getBaseAtk() << ", " << w->getBaseCritRate() << ", "
+                    << w->getBaseAtkSpeed() << ", " << w->getWeight() << "},\n";
+            weaponCount++;
+        } else if (Armor* a = dynamic_cast<Armor*>(eq)) {
+            armors << "    {" << a->getId() << ", " << cppLiteral(a->getName()) << ", "
+                   << rarityName(a->getRarity()) << ", " << cppLiteral(a->getFaction()) << ", "
+                   << a->getBaseMaxHp() << ", " << a->getBaseDodgeRate() << ", "
+                   << a->getBaseCapacity() << "},\n";
+            armorCount++;
+        }
+        delete eq;
+    }
+
+    for (size_t i = 0; i < report.monsterValid.size(); i++) {
+        if (!report.monsterValid[i]) continue;
+        Monster m = DataLoader::createMonster(j["monsters"][i]);
+        monsters << "    {" << m.id << ", " << cppLiteral(m.name) << ", "
+                 << m.hp << ", " << m.atk << ", " << m.exp << "},\n";
+        monsterCount++;
+    }
+
+    // C++ 不允许空数组，数量为 0 时放一个占位记录，以 *_COUNT 为准
+    if (weaponCount == 0) weapons << "    {0, \"\", BROKEN, \"\", 0, 0, 1, 0},\n";
+    if (armorCount == 0) armors << "    {0, \"\", BROKEN, \"\", 0, 0, 0},\n";
+    if (monsterCount == 0) monsters << "    {0, \"\", 1, 0, 0},\n";
+
+    ofstream out(outputPath);
+    if (!out.is_open()) {
+        cerr << "[错误] 无法写入文件: " << outputPath << endl;
+        return 1;
+    }
+
+    out << "// 此文件由 ContentGen 根据 gamedata.json 自动生成，请勿手动修改\n"
+        << "// 重新生成: ContentGen gamedata.json EmbeddedContentData.h\n\n"
+        << "#ifndef EMBEDDED_CONTENT_DATA_H\n"
+        << "#define EMBEDDED_CONTENT_DATA_H\n\n"
+        << "constexpr EmbeddedWeapon EMBEDDED_WEAPONS[] = {\n" << weapons.str() << "};\n"
+        << "constexpr size_t EMBEDDED_WEAPON_COUNT = " << weaponCount << ";\n\n"
+        << "constexpr EmbeddedArmor EMBEDDED_ARMORS[] = {\n" << armors.str() << "};\n"
+        << "constexpr size_t EMBEDDED_ARMOR_COUNT = " << armorCount << ";\n\n"
+        << "constexpr EmbeddedMonster EMBEDDED_MONSTERS[] = {\n" << monsters.str() << "};\n"
+        << "constexpr size_t EMBEDDED_MONSTER_COUNT = " << monsterCount << ";\n\n"
+        << "#endif // EMBEDDED_CONTENT_DATA_H\n";
+
+    cout << "[系统] 已生成 " << outputPath << "：武器 " << weaponCount << "，装甲 " << armorCount
+         << "，怪物 " << monsterCount << endl;
+    return report.ok() ? 0 : 1;
+}
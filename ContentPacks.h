@@ -0,0 +1,375 @@
+/**
+ * 文件名: ContentPacks.h
+ * 职责: 内容包 - 启动时只读取小清单，装备/怪物数据按需分包加载
+ *
+ * 清单格式 (content/manifest.json):
+ * {
+ *     "packs": [
+ *         {"name": "equipment_republic", "kind": "equipment", "file": "equipment_republic.json",
+ *          "faction": "共和国", "id_min": 101, "id_max": 246, "ids": [101, 104, ...]},
+ *         {"name": "monsters_tier2", "kind": "monsters", "file": "monsters_tier2.json",
+ *          "tier": 2, "min_difficulty": 2, "id_min": 2001, "id_max": 2050, "ids": [2001, ...]}
+ *     ]
+ * }
+ * 包文件路径相对于清单所在目录，由 ContentGen --split 根据 gamedata.json 生成。
+ * 各势力装备的 id 是交错的，按 id 查找模板时用 ids 建立的索引只加载所属的那一个包；
+ * 旧清单没有 ids 时回退为按 id 范围加载。
+ * 同时需要多个包时（例如第一次刷新商店），各包在小线程池中并行解析，最后按清单顺序合并。
+ * 同一个 id 出现在多个包中时由清单中靠前的包提供，与各包加载的先后顺序无关（见 loadPacks）。
+ */
+
+#ifndef CONTENT_PACKS_H
+#define CONTENT_PACKS_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "json.hpp"
+#include "GameCore.h"
+#include "DataLoader.h"
+#include "DataValidator.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 单个内容包的清单信息
+struct ContentPackInfo {
+    string name;
+    string kind;           // "equipment" 或 "monsters"
+    string file;           // 已解析为可直接打开的路径
+    string faction;        // 装备包：所属势力
+    int tier = 0;          // 怪物包：等级
+    int minDifficulty = 0; // 怪物包：冒险难度达到多少时需要
+    int idMin = 0;
+    int idMax = 0;
+    bool indexed = false;  // 装备包：清单列出了包内全部 id
+    bool loaded = false;
+    vector<Monster> monsters;  // 怪物包加载后的数据
+};
+
+// 单个包的解析结果（在工作线程中生成，合并前不触碰共享数据）
+struct ParsedPack {
+    vector<Equipment*> equipments;
+    vector<Monster> monsters;
+    ValidationReport report;
+    string error;  // 打开或解析失败时的错误信息
+};
+
+class ContentPacks {
+private:
+    static vector<ContentPackInfo> packs;
+    static map<int, Equipment*>* registry;  // 共享模板库（SaveManager::itemLibrary）
+    static map<int, size_t> monsterOwners;  // 怪物 id -> 提供它的内容包（清单中的下标）
+    static map<int, size_t> equipmentIndex; // 装备 id -> 所属的内容包（来自清单的 ids）
+    static bool equipmentIndexed;           // 所有装备包都列出了 ids
+    static bool active;
+
+    // 解析单个包（可在工作线程中运行：只读包信息，只写 out）
+    static void parsePack(const ContentPackInfo& pack, ParsedPack& out) {
+        ifstream f(pack.file);
+        if (!f.is_open()) {
+            out.error = "[错误] 无法打开内容包: " + pack.file;
+            return;
+        }
+
+        json j;
+        try {
+            j = json::parse(f);
+        } catch (json::parse_error& e) {
+            out.error = "[JSON错误] 内容包 " + pack.name + " 解析失败: " + e.what();
+            return;
+        }
+
+        if (pack.kind == "equipment") {
+            if (!j.contains("equipments")) j["equipments"] = json::array();
+            const json& arr = j["equipments"];
+            DataValidator::validateEquipments(arr, pack.file + ":$.equipments", out.report);
+            for (size_t i = 0; i < out.report.equipmentValid.size(); i++) {
+                if (!out.report.equipmentValid[i]) continue;
+                out.equipments.push_back(DataLoader::createEquipment(arr[i], 0));
+            }
+        } else {
+            if (!j.contains("monsters")) j["monsters"] = json::array();
+            const json& arr = j["monsters"];
+            DataValidator::validateMonsters(arr, pack.file + ":$.monsters", out.report);
+            for (size_t i = 0; i < out.report.monsterValid.size(); i++) {
+                if (!out.report.monsterValid[i]) continue;
+                out.monsters.push_back(DataLoader::createMonster(arr[i]));
+            }
+        }
+    }
+
+    // 没有 id 索引时，加载装备包之前先加载清单中靠前、id 范围与它重叠的装备包：
+    // 已合并的模板可能已被引用，不能替换，先合并靠前的包才能保证冲突的 id 总由靠前的包提供
+    static vector<size_t> withPrerequisites(const vector<size_t>& batch) {
+        if (equipmentIndexed) return batch;
+        vector<bool> wanted(packs.size(), false);
+        for (size_t i : batch) wanted[i] = true;
+        for (size_t i = packs.size(); i-- > 0;) {
+            if (!wanted[i] || packs[i].kind != "equipment") continue;
+            for (size_t k = 0; k < i; k++) {
+                if (packs[k].kind == "equipment" && !packs[k].loaded &&
+                    packs[k].idMin <= packs[i].idMax && packs[i].idMin <= packs[k].idMax) {
+                    wanted[k] = true;
+                }
+            }
+        }
+        vector<size_t> expanded;
+        for (size_t i = 0; i < packs.size(); i++) {
+            if (wanted[i]) expanded.push_back(i);
+        }
+        return expanded;
+    }
+
+    // 加载一批包：先在小线程池中并行解析，再按清单顺序串行合并
+    // id 冲突按清单顺序决定，与加载的先后和分批无关：
+    // - 装备：有 id 索引时只接收记在本包名下的 id；没有索引时靠前的重叠包先加载（withPrerequisites）
+    // - 怪物：按值保存，靠前的包后加载时替换掉靠后的包提供的同 id 怪物
+    static void loadPacks(const vector<size_t>& requested) {
+        vector<size_t> batch = withPrerequisites(requested);
+        if (batch.empty()) return;
+
+        vector<ParsedPack> parsed(batch.size());
+        size_t workerCount = thread::hardware_concurrency();
+        if (workerCount == 0) workerCount = 2;
+        workerCount = min(min(workerCount, batch.size()), static_cast<size_t>(8));
+
+        if (workerCount <= 1) {
+            for (size_t i = 0; i < batch.size(); i++) parsePack(packs[batch[i]], parsed[i]);
+        } else {
+            atomic<size_t> next(0);
+            vector<thread> workers;
+            for (size_t w = 0; w < workerCount; w++) {
+                workers.emplace_back([&]() {
+                    for (size_t i = next++; i < batch.size(); i = next++) {
+                        parsePack(packs[batch[i]], parsed[i]);
+                    }
+                });
+            }
+            for (auto& t : workers) t.join();
+        }
+
+        // batch 已按清单顺序排列
+        for (size_t i = 0; i < batch.size(); i++) {
+            ContentPackInfo& pack = packs[batch[i]];
+            ParsedPack& result = parsed[i];
+            pack.loaded = true;  // 失败也标记，避免每次访问都重试
+            if (!result.error.empty()) {
+                cout << result.error << endl;
+                continue;
+            }
+            result.report.print(cout);
+
+            for (Equipment* eq : result.equipments) {
+                if (equipmentIndexed) {
+                    auto owner = equipmentIndex.find(eq->getId());
+                    if (owner == equipmentIndex.end() || owner->second != batch[i]) {
+                        cout << "[警告] 内容包 " << pack.name << " 中的装备 id " << eq->getId()
+                             << (owner == equipmentIndex.end() ? " 不在清单的 ids 中"
+                                                                : " 由清单中靠前的内容包 " + packs[owner->second].name + " 提供")
+                             << "，已忽略。" << endl;
+                        delete eq;
+                        continue;
+                    }
+                }
+                auto inserted = registry->emplace(eq->getId(), eq);
+                if (!inserted.second) {
+                    cout << "[警告] 内容包 " << pack.name << " 中的装备 id " << eq->getId()
+                         << " 已由其他内容包提供，已忽略。" << endl;
+                    delete eq;
+                }
+            }
+            for (const Monster& m : result.monsters) {
+                auto owner = monsterOwners.find(m.id);
+                if (owner != monsterOwners.end()) {
+                    if (owner->second <= batch[i]) {
+                        cout << "[警告] 内容包 " << pack.name << " 中的怪物 id " << m.id
+                             << " 已由内容包 " << packs[owner->second].name << " 提供，已忽略。" << endl;
+                        continue;
+                    }
+                    // 清单中靠前的包后加载：取代之前由靠后的包提供的怪物
+                    vector<Monster>& previous = packs[owner->second].monsters;
+                    cout << "[警告] 怪物 id " << m.id << " 同时出现在内容包 " << pack.name << " 和 "
+                         << packs[owner->second].name << " 中，使用清单中靠前的 " << pack.name << "。" << endl;
+                    previous.erase(remove_if(previous.begin(), previous.end(),
+                                             [&m](const Monster& other) { return other.id == m.id; }),
+                                   previous.end());
+                    owner->second = batch[i];
+                } else {
+                    monsterOwners.emplace(m.id, batch[i]);
+                }
+                pack.monsters.push_back(m);
+            }
+            cout << "[系统] 已加载内容包: " << pack.name << endl;
+        }
+    }
+
+    // 收集满足条件且尚未加载的包（按清单顺序）
+    template <typename Pred>
+    static vector<size_t> pendingPacks(Pred pred) {
+        vector<size_t> batch;
+        for (size_t i = 0; i < packs.size(); i++) {
+            if (!packs[i].loaded && pred(packs[i])) batch.push_back(i);
+        }
+        return batch;
+    }
+
+public:
+    // 读取清单（只包含元数据，不读取任何包文件）
+    // items: 加载出的装备模板存放的共享模板库
+    static bool loadManifest(const string& manifestFile, map<int, Equipment*>& items) {
+        ifstream f(manifestFile);
+        if (!f.is_open()) {
+            return false;
+        }
+
+        json j;
+        try {
+            j = json::parse(f);
+        } catch (json::parse_error& e) {
+            cout << "[JSON错误] 内容清单解析失败: " << e.what() << endl;
+            return false;
+        }
+        if (!j.contains("packs") || !j["packs"].is_array()) {
+            cout << "[错误] 内容清单缺少 packs 列表: " << manifestFile << endl;
+            return false;
+        }
+
+        // 包文件相对于清单所在目录
+        string baseDir;
+        size_t slash = manifestFile.find_last_of("/\\");
+        if (slash != string::npos) baseDir = manifestFile.substr(0, slash + 1);
+
+        packs.clear();
+        equipmentIndex.clear();
+        monsterOwners.clear();
+        equipmentIndexed = true;
+        for (auto& entry : j["packs"]) {
+            ContentPackInfo pack;
+            pack.name = entry.value("name", "");
+            pack.kind = entry.value("kind", "");
+            pack.file = baseDir + entry.value("file", "");
+            pack.faction = entry.value("faction", "");
+            pack.tier = entry.value("tier", 0);
+            pack.minDifficulty = entry.value("min_difficulty", 0);
+            pack.idMin = entry.value("id_min", 0);
+            pack.idMax = entry.value("id_max", -1);
+            if (pack.kind != "equipment" && pack.kind != "monsters") {
+                cout << "[警告] 内容包 " << pack.name << " 类型未知，已忽略。" << endl;
+                continue;
+            }
+            // 装备 id 索引：同一个 id 出现在多个包中时记在清单中靠前的包名下
+            if (pack.kind == "equipment" && entry.contains("ids") && entry["ids"].is_array()) {
+                pack.indexed = true;
+                for (auto& id : entry["ids"]) {
+                    if (id.is_number_integer()) equipmentIndex.emplace(id.get<int>(), packs.size());
+                }
+            }
+            if (pack.kind == "equipment" && !pack.indexed) equipmentIndexed = false;
+            packs.push_back(pack);
+        }
+        // 只有部分装备包列出 ids 时无法按索引判断归属，全部按 id 范围处理
+        if (!equipmentIndexed) {
+            equipmentIndex.clear();
+            for (auto& pack : packs) pack.indexed = false;
+        }
+        registry = &items;
+        active = true;
+        return true;
+    }
+
+    static bool isActive() {
+        return active;
+    }
+
+    // 所有装备包都在清单中列出了 ids（按 id 查找时只加载所属的包）
+    static bool hasIdIndex() {
+        return equipmentIndexed;
+    }
+
+    // 加载提供该装备的包：清单有 ids 索引时只加载所属的包，否则加载 id 范围覆盖它的所有包
+    static void ensureEquipmentForId(int id) {
+        auto owner = equipmentIndex.find(id);
+        if (owner != equipmentIndex.end()) {
+            if (!packs[owner->second].loaded) loadPacks({owner->second});
+            return;
+        }
+        loadPacks(pendingPacks([id](const ContentPackInfo& pack) {
+            return pack.kind == "equipment" && !pack.indexed && id >= pack.idMin && id <= pack.idMax;
+        }));
+    }
+
+    // 加载某个势力的装备包（装备合并只需要同势力模板）
+    static void ensureFaction(string_view faction) {
+        loadPacks(pendingPacks([&faction](const ContentPackInfo& pack) {
+            return pack.kind == "equipment" && pack.faction == faction;
+        }));
+    }
+
+    // 加载全部装备包（商店需要完整的稀有度池）
+    static void ensureAllEquipment() {
+        loadPacks(pendingPacks([](const ContentPackInfo& pack) {
+            return pack.kind == "equipment";
+        }));
+    }
+
+    // 单独加载清单中的第 index 个包（以及保证冲突归属所需的靠前的包）
+    static void ensurePack(size_t index) {
+        if (index < packs.size() && !packs[index].loaded) loadPacks({index});
+    }
+
+    // 停用内容包（自检结束后调用，模板库由调用方释放）
+    static void reset() {
+        packs.clear();
+        equipmentIndex.clear();
+        monsterOwners.clear();
+        registry = nullptr;
+        active = false;
+    }
+
+    // 一次性并行加载所有包（服务器预热用，耗时约等于最大的单个包）
+    static void preloadAll() {
+        loadPacks(pendingPacks([](const ContentPackInfo&) { return true; }));
+    }
+
+    // 获取某个冒险难度可出现的怪物，按需加载对应的怪物包
+    static vector<Monster> getMonstersForDifficulty(int difficulty) {
+        loadPacks(pendingPacks([difficulty](const ContentPackInfo& pack) {
+            return pack.kind == "monsters" && pack.minDifficulty <= difficulty;
+        }));
+        vector<Monster> result;
+        for (auto& pack : packs) {
+            if (pack.kind != "monsters" || pack.minDifficulty > difficulty) continue;
+            result.insert(result.end(), pack.monsters.begin(), pack.monsters.end());
+        }
+        return result;
+    }
+
+    // 已加载的包数量（用于调试显示）
+    static int loadedPackCount() {
+        int count = 0;
+        for (auto& pack : packs) {
+            if (pack.loaded) count++;
+        }
+        return count;
+    }
+
+    static int packCount() {
+        return packs.size();
+    }
+};
+
+// 静态成员初始化
+vector<ContentPackInfo> ContentPacks::packs;
+map<int, Equipment*>* ContentPacks::registry = nullptr;
+map<int, size_t> ContentPacks::monsterOwners;
+map<int, size_t> ContentPacks::equipmentIndex;
+bool ContentPacks::equipmentIndexed = true;
+bool ContentPacks::active = false;
+
+#endif // CONTENT_PACKS_H
@@ -1,6 +1,45 @@
+param(
+    # -Embedded: 展台/测试构建，内容表编译进程序，启动时不读取 gamedata.json
+    [switch]$Embedded,
+    # -SaveBench: 编译并运行存档性能测试（JSON 与二进制格式对比），不启动游戏
+    [switch]$SaveBench,
+    # -ShopBench: 编译并运行商店刷新性能测试，不启动游戏
+    [switch]$ShopBench,
+    # -ShopHarness: 编译并运行商店抽取验证（百万次刷新 + 卡方检验），不启动游戏
+    [switch]$ShopHarness
+)
+
+if ($SaveBench) {
+    g++ -std=c++17 -O2 SaveBench.cpp GameCore.cpp -o SaveBench.exe
+    if ($LASTEXITCODE -eq 0) { .\SaveBench.exe }
+    exit $LASTEXITCODE
+}
+
+if ($ShopBench) {
+    g++ -std=c++17 -O2 ShopBench.cpp GameCore.cpp -o ShopBench.exe
+    if ($LASTEXITCODE -eq 0) { .\ShopBench.exe }
+    exit $LASTEXITCODE
+}
+
+if ($ShopHarness) {
+    g++ -std=c++17 -O2 ShopHarness.cpp GameCore.cpp -o ShopHarness.exe
+    if ($LASTEXITCODE -eq 0) { .\ShopHarness.exe }
+    exit $LASTEXITCODE
+}
+
 # 1. 编译 C++ 文件
 Write-Host "正在编译..." -ForegroundColor Cyan
-g++ main.cpp GameCore.cpp -o game.exe
+if ($Embedded) {
+    # 1a. 生成内嵌内容表
+    g++ -std=c++17 ContentGen.cpp GameCore.cpp -o ContentGen.exe
+    if ($LASTEXITCODE -eq 0) { .\ContentGen.exe gamedata.json EmbeddedContentData.h }
+    # 1b. 编译内嵌版本，并校验两条加载路径得到相同的模板
+    if ($LASTEXITCODE -eq 0) { g++ -std=c++17 -DEMBEDDED_CONTENT main.cpp GameCore.cpp -o game.exe }
+    if ($LASTEXITCODE -eq 0) { .\game.exe --verify-content }
+}
+else {
+    g++ -std=c++17 main.cpp GameCore.cpp -o game.exe
+}
 
 # 2. 检查编译结果 ($LASTEXITCODE 为 0 表示成功)
 if ($LASTEXITCODE -eq 0) {
@@ -7,6 +7,7 @@
 #include <vector>
 #include "json.hpp"
 #include "GameCore.h" // 引用之前的核心类
+#include "DataValidator.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -16,7 +17,7 @@ using namespace std;
 #define MONSTER_STRUCT_DEFINED
 struct Monster {
     int id;
-    string name;
+    string_view name;  // 指向字符串池，复制怪物不会分配内存
     int hp;
     int atk;
     int exp;
@@ -24,17 +25,41 @@ struct Monster {
 #endif
 
 class DataLoader {
-private:
-    // 辅助函数：将字符串转换为枚举
-    static Rarity stringToRarity(string s) {
-        if (s == "BROKEN") return BROKEN;
-        if (s == "STANDARD") return STANDARD;
-        if (s == "MILITARY") return MILITARY;
-        if (s == "LEGENDARY") return LEGENDARY;
-        return BROKEN; // 默认值
+public:
+    // 根据已校验的 JSON 条目创建装备（调用前必须通过 DataValidator 校验）
+    static Equipment* createEquipment(const json& item, int level) {
+        int id = item["id"];
+        const string& type = item["type"].get_ref<const string&>();
+        const string& name = item["name"].get_ref<const string&>();
+        const string& faction = item["faction"].get_ref<const string&>();
+        Rarity rarity = BROKEN;
+        DataValidator::parseRarity(item["rarity"].get_ref<const string&>(), rarity);
+
+        // 工厂模式的核心：根据 type 创建不同的子类
+        if (type == "weapon") {
+            int atk = item["atk"];
+            int critRate = item.value("crit_rate", 0);  // 已经是*100后的值
+            int atkSpeed = item.value("atk_speed", 1);
+            int weight = item.value("weight", 1);
+            return new Weapon(id, name, rarity, level, faction, atk, critRate, atkSpeed, weight);
+        }
+        int hp = item["hp"];
+        int dodgeRate = item.value("dodge_rate", 0);  // 已经是*100后的值
+        int capacity = item.value("capacity", 10);
+        return new Armor(id, name, rarity, level, faction, hp, dodgeRate, capacity);
+    }
+
+    // 根据已校验的 JSON 条目创建怪物
+    static Monster createMonster(const json& item) {
+        Monster m;
+        m.id = item["id"];
+        m.name = StringPool::intern(item["name"].get_ref<const string&>());
+        m.hp = item["hp"];
+        m.atk = item["atk"];
+        m.exp = item["exp"];
+        return m;
     }
 
-public:
     // 加载装备
     static vector<Equipment*> loadEquipment(const string& filename) {
         vector<Equipment*> result;
@@ -48,28 +73,13 @@ public:
         try {
             json data = json::parse(f); // 解析整个文件
 
-            for (auto& item : data) {
-                int id = item.value("id", 0);
-                string type = item["type"];
-                string name = item["name"];
-                Rarity rarity = stringToRarity(item["rarity"]);
-                int level = item["level"];
-                string faction = item["faction"];
-
-                // 工厂模式的核心：根据 type 创建不同的子类
-                if (type == "weapon") {
-                    int atk = item["atk"];
-                    int critRate = item.value("crit_rate", 0);  // 已经是*100后的值
-                    int atkSpeed = item.value("atk_speed", 1);
-                    int weight = item.value("weight", 1);
-                    result.push_back(new Weapon(id, name, rarity, level, faction, atk, critRate, atkSpeed, weight));
-                } 
-                else if (type == "armor") {
-                    int hp = item["hp"];
-                    int dodgeRate = item.value("dodge_rate", 0);  // 已经是*100后的值
-                    int capacity = item.value("capacity", 10);
-                    result.push_back(new Armor(id, name, rarity, level, faction, hp, dodgeRate, capacity));
-                }
+            ValidationReport report;
+            DataValidator::validateEquipments(data, "$", report);
+            report.print(cerr);
+
+            for (size_t i = 0; i < report.equipmentValid.size(); i++) {
+                if (!report.equipmentValid[i]) continue;  // 跳过有错误的条目
+                result.push_back(createEquipment(data[i], data[i].value("level", 1)));
             }
             cout << "[系统] 成功加载 " << result.size() << " 件装备。" << endl;
         } 
@@ -94,22 +104,17 @@ public:
             json data = json::parse(f);
             
             // 检查是否有 "monsters" 键（gamedata.json 格式）
-            json monsterArray;
-            if (data.contains("monsters")) {
-                monsterArray = data["monsters"];
-            } else {
-                // 如果没有，假设整个文件就是怪物数组（enemy.json 格式）
-                monsterArray = data;
-            }
+            // 如果没有，假设整个文件就是怪物数组（enemy.json 格式）
+            bool nested = data.is_object() && data.contains("monsters");
+            const json& monsterArray = nested ? data["monsters"] : data;
             
-            for (auto& item : monsterArray) {
-                Monster m;
-                m.id = item["id"];
-                m.name = item["name"];
-                m.hp = item["hp"];
-                m.atk = item["atk"];
-                m.exp = item["exp"];
-                result.push_back(m);
+            ValidationReport report;
+            DataValidator::validateMonsters(monsterArray, nested ? "$.monsters" : "$", report);
+            report.print(cerr);
+
+            for (size_t i = 0; i < report.monsterValid.size(); i++) {
+                if (!report.monsterValid[i]) continue;
+                result.push_back(createMonster(monsterArray[i]));
             }
             cout << "[系统] 成功加载 " << result.size() << " 个怪物数据。" << endl;
         }
@@ -120,4 +125,4 @@ public:
     }
 };
 
-#endif // DATALOADER_H
\ No newline at end of file
+#endif // DATALOADER_H
@@ -0,0 +1,268 @@
+/**
+ * 文件名: DataValidator.h
+ * 职责: 游戏数据校验 - 一次线性扫描，报告所有数据问题（带 JSON 路径）
+ */
+
+#ifndef DATA_VALIDATOR_H
+#define DATA_VALIDATOR_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <climits>
+#include "json.hpp"
+#include "GameCore.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 问题严重程度
+// ERROR: 该条目无法使用，加载时会被跳过
+// WARNING: 条目仍会加载，但数据可疑
+enum class IssueLevel { WARNING, ERROR };
+
+// 单个数据问题
+struct DataIssue {
+    IssueLevel level;
+    string path;     // JSON 路径，例如 $.equipments[3].rarity
+    string message;
+};
+
+// 校验结果
+struct ValidationReport {
+    vector<DataIssue> issues;
+    vector<char> equipmentValid;  // 与 equipments 数组一一对应，1 表示可加载
+    vector<char> monsterValid;    // 与 monsters 数组一一对应
+    int errorCount = 0;
+    int warningCount = 0;
+
+    bool ok() const { return errorCount == 0; }
+
+    void add(IssueLevel level, string path, string message) {
+        if (level == IssueLevel::ERROR) errorCount++;
+        else warningCount++;
+        issues.push_back({level, move(path), move(message)});
+    }
+
+    // 打印所有问题
+    void print(ostream& os) const {
+        if (issues.empty()) return;
+        os << "[数据校验] 发现 " << errorCount << " 个错误, " << warningCount << " 个警告：" << endl;
+        for (const auto& issue : issues) {
+            os << (issue.level == IssueLevel::ERROR ? "  [错误] " : "  [警告] ")
+               << issue.path << ": " << issue.message << endl;
+        }
+    }
+};
+
+class DataValidator {
+public:
+    // 字符串 -> 稀有度，未知字符串返回 false（所有加载器统一使用）
+    static bool parseRarity(const string& s, Rarity& out) {
+        if (s == "BROKEN") { out = BROKEN; return true; }
+        if (s == "STANDARD") { out = STANDARD; return true; }
+        if (s == "MILITARY") { out = MILITARY; return true; }
+        if (s == "LEGENDARY") { out = LEGENDARY; return true; }
+        return false;
+    }
+
+    // 校验完整的 gamedata.json（包含 equipments 和 monsters）
+    static ValidationReport validate(const json& root) {
+        ValidationReport report;
+        if (!root.is_object()) {
+            report.add(IssueLevel::ERROR, "$", "根节点必须是对象");
+            return report;
+        }
+
+        if (root.contains("equipments")) {
+            validateEquipments(root["equipments"], "$.equipments", report);
+        } else {
+            report.add(IssueLevel::ERROR, "$.equipments", "缺少装备列表");
+        }
+
+        if (root.contains("monsters")) {
+            validateMonsters(root["monsters"], "$.monsters", report);
+        } else {
+            report.add(IssueLevel::ERROR, "$.monsters", "缺少怪物列表");
+        }
+        return report;
+    }
+
+    // 校验装备数组，结果写入 report.equipmentValid
+    static void validateEquipments(const json& arr, const string& basePath, ValidationReport& report) {
+        report.equipmentValid.assign(arr.is_array() ? arr.size() : 0, 0);
+        if (!arr.is_array()) {
+            report.add(IssueLevel::ERROR, basePath, "必须是数组");
+            return;
+        }
+
+        unordered_map<int, size_t> seen;  // id -> 首次出现的下标
+        seen.reserve(arr.size());
+
+        for (size_t i = 0; i < arr.size(); i++) {
+            const json& item = arr[i];
+            // 路径只在出问题时才拼接，正常数据不产生字符串开销
+            auto path = [&](const char* key) {
+                string p = basePath + "[" + to_string(i) + "]";
+                if (key) p += string(".") + key;
+                return p;
+            };
+
+            if (!item.is_object()) {
+                report.add(IssueLevel::ERROR, path(nullptr), "条目必须是对象");
+                continue;
+            }
+
+            bool valid = true;
+            valid &= requireInt(item, "id", path, report);
+            valid &= requireString(item, "name", path, report);
+            valid &= requireString(item, "faction", path, report);
+
+            if (requireString(item, "rarity", path, report)) {
+                Rarity r;
+                if (!parseRarity(item["rarity"].get_ref<const string&>(), r)) {
+                    report.add(IssueLevel::ERROR, path("rarity"),
+                               "未知稀有度 \"" + item["rarity"].get<string>() + "\"");
+                    valid = false;
+                }
+            } else {
+                valid = false;
+            }
+
+            if (requireString(item, "type", path, report)) {
+                const string& type = item["type"].get_ref<const string&>();
+                if (type == "weapon") {
+                    valid &= requireInt(item, "atk", path, report);
+                    valid &= optionalInt(item, "crit_rate", 0, 100, path, report);
+                    valid &= optionalInt(item, "atk_speed", 1, INT_MAX, path, report);
+                    valid &= optionalInt(item, "weight", 0, INT_MAX, path, report);
+                } else if (type == "armor") {
+                    valid &= requireInt(item, "hp", path, report);
+                    valid &= optionalInt(item, "dodge_rate", 0, 100, path, report);
+                    valid &= optionalInt(item, "capacity", 0, INT_MAX, path, report);
+                } else {
+                    report.add(IssueLevel::ERROR, path("type"), "未知装备类型 \"" + type + "\"");
+                    valid = false;
+                }
+            } else {
+                valid = false;
+            }
+
+            // 重复 ID：保留首次出现的条目，后出现的跳过
+            if (item.contains("id") && item["id"].is_number_integer()) {
+                int id = item["id"];
+                auto result = seen.emplace(id, i);
+                if (!result.second) {
+                    report.add(IssueLevel::ERROR, path("id"),
+                               "重复的装备 id " + to_string(id) + "（首次出现于 " +
+                               basePath + "[" + to_string(result.first->second) + "]）");
+                    valid = false;
+                }
+            }
+
+            report.equipmentValid[i] = valid ? 1 : 0;
+        }
+    }
+
+    // 校验怪物数组，结果写入 report.monsterValid
+    static void validateMonsters(const json& arr, const string& basePath, ValidationReport& report) {
+        report.monsterValid.assign(arr.is_array() ? arr.size() : 0, 0);
+        if (!arr.is_array()) {
+            report.add(IssueLevel::ERROR, basePath, "必须是数组");
+            return;
+        }
+
+        unordered_map<int, size_t> seen;
+        seen.reserve(arr.size());
+
+        for (size_t i = 0; i < arr.size(); i++) {
+            const json& item = arr[i];
+            auto path = [&](const char* key) {
+                string p = basePath + "[" + to_string(i) + "]";
+                if (key) p += string(".") + key;
+                return p;
+            };
+
+            if (!item.is_object()) {
+                report.add(IssueLevel::ERROR, path(nullptr), "条目必须是对象");
+                continue;
+            }
+
+            bool valid = true;
+            valid &= requireInt(item, "id", path, report);
+            valid &= requireString(item, "name", path, report);
+            valid &= requireInt(item, "hp", path, report);
+            valid &= requireInt(item, "atk", path, report);
+            valid &= requireInt(item, "exp", path, report);
+
+            if (valid && item["hp"].get<int>() <= 0) {
+                report.add(IssueLevel::ERROR, path("hp"), "生命值必须大于 0");
+                valid = false;
+            }
+
+            if (item.contains("id") && item["id"].is_number_integer()) {
+                int id = item["id"];
+                auto result = seen.emplace(id, i);
+                if (!result.second) {
+                    report.add(IssueLevel::ERROR, path("id"),
+                               "重复的怪物 id " + to_string(id) + "（首次出现于 " +
+                               basePath + "[" + to_string(result.first->second) + "]）");
+                    valid = false;
+                }
+            }
+
+            report.monsterValid[i] = valid ? 1 : 0;
+        }
+    }
+
+private:
+    template <typename PathFn>
+    static bool requireInt(const json& item, const char* key, PathFn& path, ValidationReport& report) {
+        auto it = item.find(key);
+        if (it == item.end()) {
+            report.add(IssueLevel::ERROR, path(key), "缺少必要字段");
+            return false;
+        }
+        if (!it->is_number_integer()) {
+            report.add(IssueLevel::ERROR, path(key), "必须是整数");
+            return false;
+        }
+        return true;
+    }
+
+    template <typename PathFn>
+    static bool requireString(const json& item, const char* key, PathFn& path, ValidationReport& report) {
+        auto it = item.find(key);
+        if (it == item.end()) {
+            report.add(IssueLevel::ERROR, path(key), "缺少必要字段");
+            return false;
+        }
+        if (!it->is_string()) {
+            report.add(IssueLevel::ERROR, path(key), "必须是字符串");
+            return false;
+        }
+        return true;
+    }
+
+    // 可选整数字段：类型错误是 ERROR，超出范围只是 WARNING（运行时会被截断）
+    template <typename PathFn>
+    static bool optionalInt(const json& item, const char* key, int minValue, int maxValue,
+                            PathFn& path, ValidationReport& report) {
+        auto it = item.find(key);
+        if (it == item.end()) return true;
+        if (!it->is_number_integer()) {
+            report.add(IssueLevel::ERROR, path(key), "必须是整数");
+            return false;
+        }
+        int v = it->get<int>();
+        if (v < minValue || v > maxValue) {
+            report.add(IssueLevel::WARNING, path(key),
+                       "数值 " + to_string(v) + " 超出范围 [" + to_string(minValue) + ", " +
+                       (maxValue == INT_MAX ? string("∞") : to_string(maxValue)) + "]");
+        }
+        return true;
+    }
+};
+
+#endif // DATA_VALIDATOR_H
@@ -0,0 +1,49 @@
+/**
+ * 文件名: EmbeddedContent.h
+ * 职责: 编译期内嵌的内容表 - 启动时无需读取或解析 gamedata.json
+ *
+ * 数据部分 EmbeddedContentData.h 由 ContentGen 根据 gamedata.json 生成，
+ * 仅在定义了 EMBEDDED_CONTENT 的构建（展台/测试版本）中使用。
+ */
+
+#ifndef EMBEDDED_CONTENT_H
+#define EMBEDDED_CONTENT_H
+
+#include <cstddef>
+#include "GameCore.h"
+
+// 武器记录（字段与 gamedata.json 中的武器条目一一对应）
+struct EmbeddedWeapon {
+    int id;
+    const char* name;
+    Rarity rarity;
+    const char* faction;
+    int atk;
+    int critRate;
+    int atkSpeed;
+    int weight;
+};
+
+// 装甲记录
+struct EmbeddedArmor {
+    int id;
+    const char* name;
+    Rarity rarity;
+    const char* faction;
+    int hp;
+    int dodgeRate;
+    int capacity;
+};
+
+// 怪物记录
+struct EmbeddedMonster {
+    int id;
+    const char* name;
+    int hp;
+    int atk;
+    int exp;
+};
+
+#include "EmbeddedContentData.h"
+
+#endif // EMBEDDED_CONTENT_H
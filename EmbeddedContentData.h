@@ -0,0 +1,189 @@
+// 此文件由 ContentGen 根据 gamedata.json 自动生成，请勿手动修改
+// 重新生成: ContentGen gamedata.json EmbeddedContentData.h
+
+#ifndef EMBEDDED_CONTENT_DATA_H
+#define EMBEDDED_CONTENT_DATA_H
+
+constexpr EmbeddedWeapon EMBEDDED_WEAPONS[] = {
+    {101, "制式步枪", STANDARD, "共和国", 50, 10, 2, 3},
+    {102, "等离子光剑", MILITARY, "帝国", 120, 25, 1, 5},
+    {103, "生锈的铁管", BROKEN, "废土", 15, 5, 3, 2},
+    {104, "传奇狙击炮", LEGENDARY, "共和国", 300, 50, 5, 8},
+    {105, "加特林机枪", MILITARY, "帝国", 100, 100, 1, 12},
+    {106, "猪", LEGENDARY, "废土", 10000, 1, 7, 20},
+    {107, "左轮手枪", BROKEN, "废土", 30, 30, 2, 1},
+    {108, "霰弹枪", STANDARD, "废土", 40, 50, 3, 4},
+    {109, "卡宾枪", STANDARD, "废土", 20, 15, 1, 2},
+    {110, "砍刀", BROKEN, "废土", 10, 35, 1, 1},
+    {111, "巡逻手枪", STANDARD, "共和国", 45, 12, 1, 2},
+    {112, "等离子步枪·改", MILITARY, "帝国", 140, 20, 2, 6},
+    {113, "生锈匕首", BROKEN, "废土", 18, 40, 1, 1},
+    {114, "燃烧喷枪", STANDARD, "废土", 60, 8, 3, 5},
+    {115, "震荡炮", MILITARY, "共和国", 180, 15, 4, 9},
+    {116, "投掷链锤", BROKEN, "废土", 35, 5, 2, 4},
+    {117, "磁轨炮", LEGENDARY, "帝国", 420, 30, 6, 14},
+    {118, "狩猎弓", STANDARD, "废土", 55, 25, 2, 3},
+    {119, "破坏者链锯", MILITARY, "共和国", 220, 18, 1, 11},
+    {120, "古代能量弓", LEGENDARY, "废土", 360, 35, 4, 7},
+    {121, "安倍切", BROKEN, "废土", 12, 45, 1, 1},
+    {122, "短管猎枪", STANDARD, "废土", 48, 30, 2, 4},
+    {123, "重型拦截炮", MILITARY, "共和国", 190, 10, 4, 10},
+    {124, "破旧弯刀", BROKEN, "废土", 22, 20, 1, 2},
+    {125, "高压电拳", STANDARD, "帝国", 75, 8, 2, 6},
+    {126, "光学狙击枪", MILITARY, "帝国", 260, 40, 5, 9},
+    {127, "断裂铁锤", BROKEN, "废土", 40, 5, 3, 6},
+    {128, "掠夺者短弩", STANDARD, "废土", 36, 22, 2, 3},
+    {129, "离子加农", MILITARY, "共和国", 320, 28, 6, 13},
+    {130, "荒野刀刃", STANDARD, "废土", 28, 18, 1, 2},
+    {131, "狂风手炮", MILITARY, "帝国", 150, 12, 2, 7},
+    {132, "古铜战弓", STANDARD, "废土", 65, 20, 3, 5},
+    {133, "裂地锯斧", BROKEN, "废土", 55, 6, 4, 9},
+    {134, "天穹电弧枪", LEGENDARY, "共和国", 480, 22, 7, 15},
+    {135, "幽影短剑", STANDARD, "废土", 34, 33, 1, 1},
+    {136, "重装榴弹发射器", MILITARY, "共和国", 280, 5, 5, 12},
+    {137, "祭礼长弓", LEGENDARY, "废土", 340, 30, 3, 6},
+    {138, "回旋投枪", STANDARD, "废土", 52, 14, 2, 3},
+    {139, "电磁冲击锤", MILITARY, "帝国", 200, 9, 4, 10},
+    {140, "残破火把", BROKEN, "废土", 8, 2, 1, 1},
+    {141, "军用刺刀", STANDARD, "共和国", 60, 16, 1, 3},
+    {142, "深渊切割器", LEGENDARY, "帝国", 520, 28, 8, 18},
+    {143, "猎户手弩", STANDARD, "废土", 58, 19, 2, 4},
+    {144, "废铁链枪", BROKEN, "废土", 44, 7, 3, 8},
+    {145, "寂静狙击", MILITARY, "帝国", 300, 45, 6, 9},
+    {146, "风暴链刃", MILITARY, "共和国", 210, 20, 2, 10},
+    {147, "森林守护者弯刀", STANDARD, "废土", 70, 24, 1, 4},
+    {148, "古代毁灭者", LEGENDARY, "共和国", 640, 12, 10, 22},
+    {149, "夜行者短刃", BROKEN, "废土", 26, 38, 1, 1},
+    {150, "星陨导弹发射器", LEGENDARY, "帝国", 720, 40, 12, 25},
+};
+constexpr size_t EMBEDDED_WEAPON_COUNT = 50;
+
+constexpr EmbeddedArmor EMBEDDED_ARMORS[] = {
+    {201, "皮革背心", STANDARD, "帝国", 200, 10, 10},
+    {202, "反应堆外壳", MILITARY, "共和国", 500, 15, 15},
+    {203, "破损铁甲", BROKEN, "废土", 100, 5, 5},
+    {204, "泰坦机甲", LEGENDARY, "帝国", 1000, 25, 20},
+    {205, "轻型护甲", BROKEN, "废土", 80, 6, 4},
+    {206, "强化背心", STANDARD, "共和国", 220, 12, 9},
+    {207, "战术外壳", MILITARY, "帝国", 420, 14, 14},
+    {208, "断裂护胸", BROKEN, "废土", 120, 4, 5},
+    {209, "半重甲", STANDARD, "共和国", 300, 11, 11},
+    {210, "装甲外骨骼", MILITARY, "共和国", 600, 16, 16},
+    {211, "锈蚀护具", BROKEN, "废土", 90, 3, 3},
+    {212, "城市巡逻甲", STANDARD, "帝国", 240, 9, 8},
+    {213, "前线堡垒", MILITARY, "共和国", 520, 13, 15},
+    {214, "残骸护胸", BROKEN, "废土", 110, 5, 4},
+    {215, "猎手迷彩甲", STANDARD, "废土", 260, 14, 10},
+    {216, "动能盾壳", MILITARY, "帝国", 680, 12, 17},
+    {217, "裂缝胸甲", BROKEN, "废土", 95, 6, 5},
+    {218, "游骑甲衣", STANDARD, "废土", 210, 10, 9},
+    {219, "镀钛护甲", MILITARY, "共和国", 550, 15, 15},
+    {220, "古旧战铠", BROKEN, "废土", 130, 4, 6},
+    {221, "远征甲", STANDARD, "共和国", 320, 13, 12},
+    {222, "指挥官护壳", MILITARY, "帝国", 720, 18, 18},
+    {223, "漂泊者裹甲", BROKEN, "废土", 85, 7, 4},
+    {224, "防爆背甲", STANDARD, "帝国", 270, 8, 10},
+    {225, "战地隔离层", MILITARY, "共和国", 480, 14, 13},
+    {226, "破布护胸", BROKEN, "废土", 70, 2, 3},
+    {227, "巡逻短甲", STANDARD, "废土", 200, 9, 7},
+    {228, "能量屏障甲", MILITARY, "帝国", 640, 17, 16},
+    {229, "磨损护具", BROKEN, "废土", 105, 5, 5},
+    {230, "医疗支援甲", STANDARD, "共和国", 290, 11, 11},
+    {231, "斥候外壳", STANDARD, "废土", 230, 16, 9},
+    {232, "动能反射甲", MILITARY, "共和国", 700, 12, 17},
+    {233, "遗弃装甲", BROKEN, "废土", 115, 6, 6},
+    {234, "先锋护甲", STANDARD, "帝国", 340, 10, 12},
+    {235, "指挥甲胄", MILITARY, "共和国", 760, 15, 18},
+    {236, "禁区钝甲", BROKEN, "废土", 125, 3, 6},
+    {237, "精英护甲", MILITARY, "帝国", 820, 19, 19},
+    {238, "古战士胸甲", LEGENDARY, "共和国", 1200, 22, 22},
+    {239, "星陨战装", LEGENDARY, "帝国", 1400, 24, 24},
+    {240, "遗迹守护甲", LEGENDARY, "废土", 1100, 20, 20},
+    {241, "战神铠甲", LEGENDARY, "共和国", 1600, 30, 26},
+    {242, "掠夺者外甲", STANDARD, "废土", 280, 12, 10},
+    {243, "密探轻甲", STANDARD, "帝国", 210, 17, 8},
+    {244, "炼钢胸甲", MILITARY, "共和国", 900, 14, 20},
+    {245, "幽影护具", LEGENDARY, "废土", 1300, 28, 23},
+    {246, "远古守护甲", LEGENDARY, "共和国", 1800, 35, 30},
+    {247, "侦察护甲", STANDARD, "废土", 195, 15, 7},
+    {248, "重装阻能甲", MILITARY, "帝国", 980, 13, 21},
+    {249, "破碎战袍", BROKEN, "废土", 140, 5, 6},
+    {250, "终极守卫甲", LEGENDARY, "帝国", 1500, 27, 25},
+};
+constexpr size_t EMBEDDED_ARMOR_COUNT = 50;
+
+constexpr EmbeddedMonster EMBEDDED_MONSTERS[] = {
+    {1001, "废铁史莱姆", 50, 5, 10},
+    {1002, "废土游荡者", 100, 15, 25},
+    {1003, "机械蜘蛛", 150, 20, 40},
+    {1004, "废铁守卫", 200, 25, 60},
+    {1005, "腐蚀机器人", 300, 35, 100},
+    {1006, "狂暴挖掘机", 500, 50, 150},
+    {1007, "泰坦哨兵", 800, 70, 250},
+    {2001, "腐蚀蠕虫", 70, 8, 12},
+    {2002, "变异野狗", 90, 12, 18},
+    {2003, "辐射甲虫", 60, 10, 15},
+    {2004, "拾荒者匪徒", 120, 18, 28},
+    {2005, "废弃侦察机", 130, 22, 35},
+    {2006, "毒液爬行者", 85, 14, 20},
+    {2007, "狂怒收割者", 180, 30, 45},
+    {2008, "电子幽魂", 95, 16, 22},
+    {2009, "废料巨人", 250, 40, 70},
+    {2010, "锈蚀猎犬", 110, 20, 30},
+    {2011, "自动炮台", 140, 25, 38},
+    {2012, "辐射秃鹫", 80, 11, 17},
+    {2013, "机械蝎子", 160, 28, 42},
+    {2014, "变异巨鼠", 65, 9, 14},
+    {2015, "废弃坦克残骸", 350, 45, 90},
+    {2016, "电击水母", 100, 19, 26},
+    {2017, "拾荒者头目", 220, 35, 55},
+    {2018, "腐蚀飞龙", 280, 42, 75},
+    {2019, "幽灵步兵", 130, 24, 32},
+    {2020, "辐射巨蚁", 150, 26, 36},
+    {2021, "机械鹰", 115, 21, 29},
+    {2022, "废土暴徒", 190, 32, 48},
+    {2023, "腐蚀树精", 200, 28, 50},
+    {2024, "自爆机器人", 50, 40, 25},
+    {2025, "变异毒蛛", 170, 30, 44},
+    {2026, "废弃机甲", 400, 55, 110},
+    {2027, "辐射鳄鱼", 240, 38, 65},
+    {2028, "拾荒者狙击手", 140, 34, 40},
+    {2029, "机械蜈蚣", 210, 36, 58},
+    {2030, "腐蚀泥怪", 180, 25, 46},
+    {2031, "废土狼王", 260, 44, 80},
+    {2032, "自动哨戒炮", 120, 29, 34},
+    {2033, "辐射巨蟒", 320, 48, 95},
+    {2034, "机械猛犸", 600, 60, 130},
+    {2035, "拾荒者重甲兵", 280, 42, 72},
+    {2036, "幽灵战机", 180, 38, 54},
+    {2037, "腐蚀巨像", 450, 58, 120},
+    {2038, "变异犀牛", 380, 52, 105},
+    {2039, "废弃战舰残骸", 700, 65, 140},
+    {2040, "辐射秃鹫王", 220, 46, 78},
+    {2041, "机械暴君", 550, 70, 160},
+    {2042, "拾荒者巫师", 160, 32, 52},
+    {2043, "腐蚀泰坦", 900, 80, 20},
+    {2044, "虚空潜伏者", 320, 55, 115},
+    {2045, "废钢吞噬者", 480, 62, 135},
+    {2046, "辐射君王", 850, 75, 180},
+    {2047, "量子蠕变体", 210, 47, 85},
+    {2048, "锈蚀缝合怪", 370, 58, 125},
+    {2049, "数据幽灵", 180, 41, 68},
+    {2050, "废土巨像", 950, 82, 210},
+    {3001, "智械突击兵", 240, 40, 68},
+    {3002, "机械蜂群", 80, 28, 35},
+    {3003, "重装粉碎者", 520, 55, 140},
+    {3004, "光学迷彩猎手", 190, 46, 72},
+    {3005, "堡垒防御者", 680, 38, 155},
+    {3006, "潜行斥候", 110, 18, 25},
+    {3007, "突进步卒", 160, 25, 40},
+    {3008, "重装卫士", 280, 22, 55},
+    {3009, "隐匿射手", 130, 35, 45},
+    {3010, "王国匠人", 140, 20, 38},
+    {3011, "边疆铁骑", 680, 55, 150},
+    {3012, "战争巨像", 1200, 70, 250},
+    {3013, "部落巫师", 180, 26, 55},
+};
+constexpr size_t EMBEDDED_MONSTER_COUNT = 70;
+
+#endif // EMBEDDED_CONTENT_DATA_H
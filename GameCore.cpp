@@ -13,8 +13,8 @@ using json = nlohmann::json;
 // 析构函数实现 (即使为空也需要写出来)
 Equipment::~Equipment() {}
 
-// 获取名字
-string Equipment::getName() const {
+// 获取名字（字符串池中的视图，不产生拷贝）
+string_view Equipment::getName() const {
     return name;
 }
 
@@ -35,7 +35,7 @@ Equipment* Equipment::operator+(const Equipment& other) {
     int newLevel = max(this->level, other.level) + 1;
     
     // 逻辑：新名字 = 加上前缀
-    string newName = "强化型-" + this->name; 
+    string newName = "强化型-" + string(this->name); 
     
     // 调用子类的 clone 方法生成新对象
     // 注意：这里的 *this 代表当前对象，我们调用自己的 clone
@@ -9,8 +9,10 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm> // 用于 std::max
+#include "StringPool.h" // 名称/势力字符串统一存放在字符串池中
 
 // 命名空间管理，避免冲突
 using namespace std;
@@ -18,19 +20,32 @@ using namespace std;
 // 装备稀有度
 enum Rarity { BROKEN, STANDARD, MILITARY, LEGENDARY };
 
+// 构造参数标记：名称和势力已在字符串池中（克隆时沿用原对象的），构造时不再查池
+struct PooledStrings {};
+
 // [基类] 装备
 // 这是一个抽象基类 (Abstract Base Class)，不能直接实例化
 class Equipment {
 protected:
-    string name;      // 装备名称
+    string_view name;      // 装备名称（指向字符串池，克隆时不复制）
     Rarity rarity;    // 稀有度
     int level;        // 等级
-    string faction;   // 势力
+    string_view faction;   // 势力（指向字符串池）
     int tid;
 public:
-    // 构造函数
-    Equipment(int id,string n, Rarity r, int lv, string fac): tid(id), name(n), rarity(r), level(lv), faction(fac) {}
+    // 构造函数（从数据文件加载：名称和势力放入字符串池）
+    Equipment(int id, string_view n, Rarity r, int lv, string_view fac)
+        : name(StringPool::intern(n)), rarity(r), level(lv), faction(StringPool::intern(fac)), tid(id) {}
+    // 名称和势力已在池中（克隆、购买、读档），不加锁查池
+    Equipment(int id, string_view n, Rarity r, int lv, string_view fac, PooledStrings)
+        : name(n), rarity(r), level(lv), faction(fac), tid(id) {}
     int getId() const { return tid; }
+protected:
+    // 克隆时的新名称：与原名称相同（购买、读档）时直接沿用，合成出的新名称才放入字符串池
+    string_view pooledName(string_view newName) const {
+        return newName.data() == name.data() && newName.size() == name.size() ? name : StringPool::intern(newName);
+    }
+public:
     // 虚析构函数 (重要：父类必须有虚析构，否则子类内存无法释放)
     virtual ~Equipment();
 
@@ -39,17 +54,17 @@ public:
     virtual string getDescription() const = 0;   // 获取描述文本
     
     // --- 核心逻辑接口 (由架构师实现) ---
-    string getName() const;
+    string_view getName() const;
     int getLevel() const;
     Rarity getRarity() const;
-    string getFaction() const { return faction; }
+    string_view getFaction() const { return faction; }
     
     // 运算符重载：实现"合成"功能
     // 声明：两个 Equipment 指针的内容相加，返回一个新的 Equipment 指针
     Equipment* operator+(const Equipment& other);
 
     // 原型模式：用于克隆对象，辅助合成
-    virtual Equipment* clone(string newName, int newLv) const = 0;
+    virtual Equipment* clone(string_view newName, int newLv) const = 0;
     
     // 升级系统接口
     virtual bool canLevelUp() const = 0;
@@ -84,8 +99,11 @@ private:
     }
 
 public:
-    Weapon(int id, string n, Rarity r, int lv, string fac, int attack, int crit, int speed, int w)
+    Weapon(int id, string_view n, Rarity r, int lv, string_view fac, int attack, int crit, int speed, int w)
         : Equipment(id, n, r, lv, fac), baseAtk(attack), baseCritRate(crit), baseAtkSpeed(speed), weight(w) {}
+    Weapon(int id, string_view n, Rarity r, int lv, string_view fac, PooledStrings pooled,
+           int attack, int crit, int speed, int w)
+        : Equipment(id, n, r, lv, fac, pooled), baseAtk(attack), baseCritRate(crit), baseAtkSpeed(speed), weight(w) {}
 
     // Getter 方法 - 返回实际值
     int getAtk() const { return getActualAtk(); }
@@ -151,13 +169,13 @@ public:
                " | 暴击率: " + to_string(getActualCritRate()) + "%" +
                " | 速度: " + to_string(getActualAtkSpeed()) + "回合/次" +
                " | 重量: " + to_string(weight) +
-               " | 势力: " + faction;
+               " | 势力: " + string(faction);
     }
 
     // 实现克隆，用于合成
-    Equipment* clone(string newName, int newLv) const override {
+    Equipment* clone(string_view newName, int newLv) const override {
         // 合成后攻击力提升 50%
-        return new Weapon(this->tid, newName, this->rarity, newLv, this->faction, 
+        return new Weapon(this->tid, pooledName(newName), this->rarity, newLv, this->faction, PooledStrings(),
                          this->baseAtk * 1.5, this->baseCritRate, this->baseAtkSpeed, this->weight);
     }
 };
@@ -184,8 +202,10 @@ private:
     }
 
 public:
-    Armor(int id, string n, Rarity r, int lv, string fac, int hp, int dodge, int cap)
+    Armor(int id, string_view n, Rarity r, int lv, string_view fac, int hp, int dodge, int cap)
         : Equipment(id, n, r, lv, fac), baseMaxHp(hp), baseDodgeRate(dodge), baseCapacity(cap) {}
+    Armor(int id, string_view n, Rarity r, int lv, string_view fac, PooledStrings pooled, int hp, int dodge, int cap)
+        : Equipment(id, n, r, lv, fac, pooled), baseMaxHp(hp), baseDodgeRate(dodge), baseCapacity(cap) {}
 
     // Getter 方法 - 返回实际值
     int getMaxHp() const { return getActualMaxHp(); }
@@ -248,11 +268,11 @@ public:
         return "[装甲] 血量: " + to_string(getActualMaxHp()) + 
                " | 闪避率: " + to_string(getActualDodgeRate()) + "%" +
                " | 承重: " + to_string(getActualCapacity()) +
-               " | 势力: " + faction;
+               " | 势力: " + string(faction);
     }
 
-    Equipment* clone(string newName, int newLv) const override {
-        return new Armor(this->tid, newName, this->rarity, newLv, this->faction, 
+    Equipment* clone(string_view newName, int newLv) const override {
+        return new Armor(this->tid, pooledName(newName), this->rarity, newLv, this->faction, PooledStrings(),
                         this->baseMaxHp + 200, this->baseDodgeRate, this->baseCapacity + 5);
     }
 };
@@ -0,0 +1,247 @@
+/**
+ * 文件名: SaveBench.cpp
+ * 职责: 存档性能测试 - 比较 JSON 文本与 MessagePack 二进制存档的读写耗时和文件大小
+ *
+ * 用法: SaveBench [背包件数...]      默认测试 100、10000、1000000 件
+ * 整体: 保存 = 构建整个存档 json + 编码 + 原子写入；读取 = 读文件 + 解码 + 还原背包装备。
+ * 流式: 保存 = SaveWriter 逐件写出（游戏内的做法）；读取 = SaveReader 边解析边还原装备。
+ *
+ * 用法: SaveBench --history [背包件数...]   默认测试 1000、100000 件
+ * 存档历史: 连续保存 100 个快照（每次改动一件装备的等级，每 10 次新增一件），
+ * 统计每次存入历史的耗时、新写入的数据量，以及历史总占用与 100 份完整副本的对比。
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "SaveManager.h"
+
+using namespace std;
+
+struct BenchResult {
+    double saveMs = 0;
+    double loadMs = 0;
+    size_t bytes = 0;
+    bool ok = false;
+};
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static BenchResult runStreaming(const vector<Equipment*>& inventory, SaveFormat format, const string& file) {
+    BenchResult r;
+
+    auto start = chrono::steady_clock::now();
+    PlayerSnapshot snap;
+    snap.playerName = "Bench";
+    snap.exp = 12345;
+    snap.items.assign(inventory);
+    if (!SaveWriter::write(file, SaveManager::buildSaveFields(snap), snap.items, format)) {
+        cout << "[错误] 无法写入 " << file << endl;
+        return r;
+    }
+    r.saveMs = elapsedMs(start);
+    snap = PlayerSnapshot();
+
+    start = chrono::steady_clock::now();
+    vector<Equipment*> restored;
+    SaveReadResult save;
+    bool ok = SaveReader::read(file, save, [&restored](int tid, int lv, int) {
+        if (Equipment* prototype = SaveManager::getItemTemplate(tid)) {
+            restored.push_back(prototype->clone(prototype->getName(), lv));
+        }
+    });
+    r.loadMs = elapsedMs(start);
+    r.bytes = save.fileSize;
+
+    r.ok = ok && save.format == format && restored.size() == inventory.size();
+    for (auto eq : restored) delete eq;
+    SaveIO::removeFile(file);
+    return r;
+}
+
+static BenchResult runOnce(const vector<Equipment*>& inventory, SaveFormat format, const string& file) {
+    BenchResult r;
+    vector<Equipment*> weapons;
+
+    auto start = chrono::steady_clock::now();
+    json saveJson = SaveManager::buildSaveJson("Bench", inventory, 12345, nullptr, weapons);
+    string data = SaveCodec::encode(saveJson, format);
+    if (!SaveIO::atomicWrite(file, data)) {
+        cout << "[错误] 无法写入 " << file << endl;
+        return r;
+    }
+    r.saveMs = elapsedMs(start);
+    r.bytes = data.size();
+    saveJson = json();
+    data = string();
+
+    start = chrono::steady_clock::now();
+    string loaded;
+    json j;
+    SaveFormat detected;
+    string error;
+    SaveIO::readFile(file, loaded);
+    if (!SaveCodec::decode(loaded, j, detected, error)) {
+        cout << "[错误] " << error << endl;
+        return r;
+    }
+    vector<Equipment*> restored = SaveManager::buildInventory(j["inventory"]);
+    r.loadMs = elapsedMs(start);
+
+    r.ok = detected == format && restored.size() == inventory.size();
+    for (auto eq : restored) delete eq;
+    SaveIO::removeFile(file);
+    return r;
+}
+
+struct HistoryResult {
+    double addMs = 0;           // 平均每次存入历史的耗时
+    size_t newBytes = 0;        // 第一次之后平均每次新写入的数据块字节数
+    size_t fullBytes = 0;       // 100 个快照文件的总大小（不去重时的占用）
+    size_t diskBytes = 0;       // 历史实际占用
+    bool ok = false;
+};
+
+static HistoryResult runHistory(vector<Equipment*>& inventory, SaveFormat format, const string& file,
+                                const vector<Equipment*>& templates) {
+    const int snapshots = 100;
+    const string slot = "bench_history";
+    HistoryResult r;
+    SaveHistory::clear(slot);
+
+    srand(42);
+    uint32_t firstCrc = 0, lastCrc = 0;
+    for (int i = 0; i < snapshots; i++) {
+        // 模拟一次升级：替换为等级不同的同一件装备
+        size_t k = static_cast<size_t>(rand()) % inventory.size();
+        Equipment* old = inventory[k];
+        inventory[k] = old->clone(old->getName(), old->getLevel() % 3 + 1);
+        delete old;
+        if (i % 10 == 9) {
+            Equipment* t = templates[static_cast<size_t>(rand()) % templates.size()];
+            inventory.push_back(t->clone(t->getName(), 1));
+        }
+
+        PlayerSnapshot snap;
+        snap.playerName = "Bench";
+        snap.exp = 12345 + i;
+        snap.items.assign(inventory);
+        json fields = SaveManager::buildSaveFields(snap);
+        fields["journal_gen"] = i;
+        size_t size;
+        uint32_t crc;
+        if (!SaveWriter::write(file, fields, snap.items, format) || !Checksum::crc32cFile(file, size, crc)) {
+            cout << "[错误] 无法写入 " << file << endl;
+            return r;
+        }
+        r.fullBytes += size;
+        if (i == 0) firstCrc = crc;
+        lastCrc = crc;
+
+        SaveHistory::AddStats stats;
+        auto start = chrono::steady_clock::now();
+        if (!SaveHistory::add(slot, file, "bench", snap.playerName, snap.exp, inventory.size(), format, &stats)) {
+            cout << "[错误] 存入历史失败" << endl;
+            return r;
+        }
+        r.addMs += elapsedMs(start);
+        if (i > 0) r.newBytes += stats.newBytes;
+    }
+    r.addMs /= snapshots;
+    r.newBytes /= snapshots - 1;
+    r.diskBytes = SaveHistory::diskUsage(slot);
+
+    // 回滚最旧和最新的快照，校验与当时写入的文件完全一致
+    vector<SaveHistory::Entry> entries = SaveHistory::list(slot);
+    string error;
+    size_t size;
+    uint32_t crc;
+    r.ok = entries.size() == static_cast<size_t>(snapshots) &&
+           SaveHistory::restore(slot, entries.front().id, file, error) &&
+           Checksum::crc32cFile(file, size, crc) && crc == firstCrc &&
+           SaveHistory::restore(slot, entries.back().id, file, error) &&
+           Checksum::crc32cFile(file, size, crc) && crc == lastCrc;
+    if (!error.empty()) cout << "[错误] " << error << endl;
+
+    SaveHistory::clear(slot);
+    SaveIO::removeFile(file);
+    return r;
+}
+
+static void benchHistory(const vector<size_t>& sizes, const vector<Equipment*>& templates) {
+    cout << "\n件数        格式            存入(ms/次)   新写入(KB/次)   100 份副本(KB)   历史占用(KB)   占比" << endl;
+    for (size_t n : sizes) {
+        for (SaveFormat format : {SaveFormat::JSON, SaveFormat::MSGPACK}) {
+            // 随机背包：真实背包中装备的排列没有规律
+            srand(7);
+            vector<Equipment*> inventory;
+            for (size_t i = 0; i < n; i++) {
+                Equipment* t = templates[static_cast<size_t>(rand()) % templates.size()];
+                inventory.push_back(t->clone(t->getName(), 1 + rand() % 3));
+            }
+            HistoryResult r = runHistory(inventory, format, "save_bench.tmp", templates);
+            cout << left << setw(12) << n << setw(16) << (format == SaveFormat::JSON ? "JSON" : "MessagePack")
+                 << right << fixed << setprecision(2)
+                 << setw(12) << r.addMs << setw(16) << r.newBytes / 1024.0
+                 << setw(17) << r.fullBytes / 1024.0 << setw(15) << r.diskBytes / 1024.0
+                 << setw(7) << (r.fullBytes ? 100.0 * r.diskBytes / r.fullBytes : 0) << "%"
+                 << (r.ok ? "" : "  [失败]") << endl;
+            for (auto eq : inventory) delete eq;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool history = argc > 1 && strcmp(argv[1], "--history") == 0;
+    vector<size_t> sizes;
+    for (int i = history ? 2 : 1; i < argc; i++) sizes.push_back(strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = history ? vector<size_t>{1000, 100000} : vector<size_t>{100, 10000, 1000000};
+
+    SaveManager::initContent("content/manifest.json", "gamedata.json");
+    vector<Equipment*> templates = SaveManager::getAllEquipmentTemplates();
+    if (templates.empty()) {
+        cout << "[错误] 没有可用的装备模板。" << endl;
+        return 1;
+    }
+
+    if (history) {
+        benchHistory(sizes, templates);
+        SaveManager::cleanUp();
+        return 0;
+    }
+
+    cout << "\n件数        格式                  保存(ms)    读取(ms)    文件大小(KB)" << endl;
+    for (size_t n : sizes) {
+        vector<Equipment*> inventory;
+        inventory.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            Equipment* t = templates[i % templates.size()];
+            inventory.push_back(t->clone(t->getName(), 1 + i % 3));
+        }
+
+        for (bool streaming : {false, true}) {
+            for (SaveFormat format : {SaveFormat::JSON, SaveFormat::MSGPACK}) {
+                BenchResult r = streaming ? runStreaming(inventory, format, "save_bench.tmp")
+                                          : runOnce(inventory, format, "save_bench.tmp");
+                string label = format == SaveFormat::JSON ? "JSON" : "MessagePack";
+                label += streaming ? " 流式" : " 整体";
+                cout << left << setw(12) << n << setw(22) << label
+                     << right << fixed << setprecision(2)
+                     << setw(10) << r.saveMs << setw(12) << r.loadMs
+                     << setw(16) << r.bytes / 1024.0
+                     << (r.ok ? "" : "  [失败]") << endl;
+            }
+        }
+
+        for (auto eq : inventory) delete eq;
+    }
+
+    SaveManager::cleanUp();
+    return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * 文件名: SaveFormat.h
+ * 职责: 存档编码 - JSON 文本格式与 MessagePack 二进制格式的编码/自动识别
+ *
+ * 二进制存档布局:
+ *   [0..3] 魔数 "CRSV"
+ *   [4]    格式版本 (当前为 2)
+ *   [5]    编码方式 (1 = MessagePack)
+ *   [6..7] 保留，写 0
+ *   [8..]  若干分段，每段: [1 字节名字长度][名字][4 字节长度][4 字节 CRC32C][MessagePack 内容]
+ *          第一段 "main" 是玩家数据，之后是 SECTIONS 中的独立分段（如 "shops"）
+ * 版本 1 的二进制存档没有分段，[8..] 直接是整个存档的 MessagePack，仍可读取。
+ *
+ * JSON 存档保持原来的缩进文本，不带文件头；独立分段的校验和写在 "section_crc" 中。
+ * 读取时根据魔数自动区分两种格式。
+ *
+ * 分段校验：独立分段损坏（校验和不一致或无法解码）时只丢弃该分段，
+ * 其余存档照常读取；玩家数据损坏才视为整个存档损坏。
+ */
+
+#ifndef SAVE_FORMAT_H
+#define SAVE_FORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "json.hpp"
+#include "Checksum.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+enum class SaveFormat {
+    JSON = 0,     // 缩进文本，便于手动查看和修改
+    MSGPACK = 1   // 二进制，体积小、读写快
+};
+
+class SaveCodec {
+private:
+    static uint32_t getU32(const string& data, size_t pos) {
+        return readU32(data.data() + pos);
+    }
+
+    static void putSection(string& out, const string& name, const json& content) {
+        string bytes;
+        json::to_msgpack(content, bytes);
+        out += static_cast<char>(name.size());
+        out += name;
+        putU32(out, static_cast<uint32_t>(bytes.size()));
+        putU32(out, Checksum::crc32c(bytes));
+        out += bytes;
+    }
+
+    static bool decodeSections(const string& data, json& out, string& error, vector<string>& damaged) {
+        size_t pos = HEADER_SIZE;
+        bool first = true;
+        bool truncated = false;
+        while (pos < data.size()) {
+            // 文件被截断时，之后的分段都无法定位
+            size_t nameLen = static_cast<uint8_t>(data[pos]);
+            if (pos + 1 + nameLen + 8 > data.size()) {
+                truncated = true;
+                break;
+            }
+            string name = data.substr(pos + 1, nameLen);
+            pos += 1 + nameLen;
+            size_t size = getU32(data, pos);
+            uint32_t crc = getU32(data, pos + 4);
+            pos += 8;
+            if (size > data.size() - pos) {
+                truncated = true;
+                break;
+            }
+
+            json content;
+            bool intact = Checksum::crc32c(data.data() + pos, size) == crc;
+            if (intact) {
+                content = json::from_msgpack(data.begin() + pos, data.begin() + pos + size, true, false);
+                intact = !content.is_discarded();
+            }
+            pos += size;
+
+            if (first) {
+                if (!intact || !content.is_object()) {
+                    error = "玩家数据校验和不一致";
+                    return false;
+                }
+                out = move(content);
+                first = false;
+            } else if (intact) {
+                out[name] = move(content);
+            } else {
+                damaged.push_back(name);
+            }
+        }
+        if (first) {
+            error = "二进制存档不完整";
+            return false;
+        }
+        if (truncated) {
+            for (const char* section : SECTIONS) {
+                if (!out.contains(section) && find(damaged.begin(), damaged.end(), section) == damaged.end()) {
+                    damaged.push_back(section);
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    // 分段头中的长度和校验和均为小端 4 字节
+    static void putU32(string& out, uint32_t v) {
+        for (int i = 0; i < 4; i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+    }
+
+    static uint32_t readU32(const char* p) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+        return v;
+    }
+
+    static constexpr char MAGIC[4] = {'C', 'R', 'S', 'V'};
+    static constexpr uint8_t VERSION = 2;
+    static constexpr size_t HEADER_SIZE = 8;
+    // 可以单独校验、单独丢弃的存档分段（存档顶层的键）
+    static constexpr const char* SECTIONS[] = {"shops"};
+
+    static const char* formatName(SaveFormat format) {
+        return format == SaveFormat::MSGPACK ? "二进制 (MessagePack)" : "JSON 文本";
+    }
+
+    // JSON 存档中 section_crc 的内容；没有独立分段时为 null
+    static json sectionChecksums(const json& j) {
+        json sectionCrc;
+        for (const char* section : SECTIONS) {
+            if (j.contains(section)) sectionCrc[section] = Checksum::crc32c(j[section].dump());
+        }
+        return sectionCrc;
+    }
+
+    // 校验并移除 JSON 存档中的 section_crc，校验失败的分段从 out 中删除并记入 damaged
+    // 旧存档没有 section_crc，不做分段校验
+    static void checkSections(json& out, vector<string>& damaged) {
+        if (!out.contains("section_crc")) return;
+        json sectionCrc = out["section_crc"];
+        out.erase("section_crc");
+        for (const char* section : SECTIONS) {
+            if (!out.contains(section)) continue;
+            if (!sectionCrc.contains(section) ||
+                sectionCrc[section] != Checksum::crc32c(out[section].dump())) {
+                out.erase(section);
+                damaged.push_back(section);
+            }
+        }
+    }
+
+    // 编码存档；j 中的独立分段会被临时移出，返回前原样放回
+    static string encode(json& j, SaveFormat format) {
+        if (format == SaveFormat::JSON) {
+            json sectionCrc = sectionChecksums(j);
+            if (!sectionCrc.is_null()) j["section_crc"] = sectionCrc;
+            string out = j.dump(4); // 缩进4空格，美观
+            j.erase("section_crc");
+            return out;
+        }
+        string out(MAGIC, sizeof(MAGIC));
+        out += static_cast<char>(VERSION);
+        out += static_cast<char>(SaveFormat::MSGPACK);
+        out += '\0';
+        out += '\0';
+
+        vector<pair<string, json>> sections;
+        for (const char* section : SECTIONS) {
+            if (!j.contains(section)) continue;
+            sections.emplace_back(section, move(j[section]));
+            j.erase(section);
+        }
+        putSection(out, "main", j);
+        for (auto& section : sections) {
+            putSection(out, section.first, section.second);
+            j[section.first] = move(section.second);
+        }
+        return out;
+    }
+
+    static bool hasHeader(const string& data) {
+        return data.size() >= HEADER_SIZE && data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    // 解码存档内容并识别格式；失败时返回 false 并给出原因
+    // damaged: 返回校验失败而被丢弃的独立分段名（其余内容仍然有效）
+    static bool decode(const string& data, json& out, SaveFormat& format, string& error,
+                       vector<string>& damaged) {
+        damaged.clear();
+        if (!hasHeader(data)) {
+            format = SaveFormat::JSON;
+            out = json::parse(data, nullptr, false);
+            if (out.is_discarded() || !out.is_object()) {
+                error = "JSON 解析失败";
+                return false;
+            }
+            checkSections(out, damaged);
+            return true;
+        }
+
+        uint8_t version = static_cast<uint8_t>(data[4]);
+        uint8_t encoding = static_cast<uint8_t>(data[5]);
+        if (version > VERSION) {
+            error = "存档格式版本 " + to_string(version) + " 高于当前程序支持的版本";
+            return false;
+        }
+        if (encoding != static_cast<uint8_t>(SaveFormat::MSGPACK)) {
+            error = "未知的存档编码 " + to_string(encoding);
+            return false;
+        }
+
+        format = SaveFormat::MSGPACK;
+        if (version >= 2) {
+            return decodeSections(data, out, error, damaged);
+        }
+        out = json::from_msgpack(data.begin() + HEADER_SIZE, data.end(), true, false);
+        if (out.is_discarded()) {
+            error = "二进制存档解析失败";
+            return false;
+        }
+        return true;
+    }
+
+    static bool decode(const string& data, json& out, SaveFormat& format, string& error) {
+        vector<string> damaged;
+        return decode(data, out, format, error, damaged);
+    }
+};
+
+#endif // SAVE_FORMAT_H
@@ -0,0 +1,374 @@
+/**
+ * 文件名: SaveHistory.h
+ * 职责: 存档历史 - 每个槽位保留最近若干个完整快照，可随时回滚（升级失败、合并后悔）
+ *
+ * 目录结构 saves/history/<槽位名>/:
+ *   index.json        历史条目列表（时间、说明、玩家信息、文件大小和 CRC32C）
+ *   <id>.manifest     该快照由哪些数据块按顺序拼成，每行一个块名
+ *   chunks/<块名>     数据块，以内容命名（64 位 FNV-1a + CRC32C + 长度），相同内容只存一份
+ *
+ * 快照文件按内容切块（256 字节窗口的 buzhash 滚动哈希，平均约 1.5KB）：块边界只取决于前 256 字节，
+ * 改动一件装备只影响它所在的一两个块，插入或删除装备后的块边界也会重新对齐。
+ * 每次保存都会变的只有文件开头（段校验和、EXP）和末尾所在的块，加上改动的装备所在的块，
+ * 因此改动一件装备的快照只新写入几 KB；块越小新写入越少，但清单越长、文件越多。
+ * 存档内容重复度很高（每件装备只有 id、等级、稀有度不同），窗口太短时几乎找不到切分点，
+ * 所以窗口要覆盖好几件装备。
+ *
+ * 每个新数据块都经 SaveIO::atomicWrite 写入（fsync 后重命名），之后才写清单和 index.json；
+ * 复用已有的同名块前核对文件大小。回滚时逐块核对 CRC32C 和长度，并核对整个文件的校验和，
+ * 数据块缺失或损坏时拒绝回滚。
+ */
+
+#ifndef SAVE_HISTORY_H
+#define SAVE_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <unordered_set>
+#include "json.hpp"
+#include "SaveIO.h"
+#include "SaveFormat.h"
+#include "Checksum.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+class SaveHistory {
+public:
+    struct Entry {
+        int id = 0;
+        long long savedAt = 0;    // Unix 时间戳
+        string label;             // 例如 "手动存档"、"升级前: 光束步枪"
+        string playerName;
+        int exp = 0;
+        size_t itemCount = 0;
+        SaveFormat format = SaveFormat::JSON;
+        size_t size = 0;          // 快照文件字节数
+        uint32_t checksum = 0;    // 快照文件的 CRC32C
+        size_t chunkCount = 0;
+    };
+
+    // 一次存入的统计（性能测试用）
+    struct AddStats {
+        size_t chunks = 0;        // 快照被切成的块数
+        size_t newChunks = 0;     // 其中需要新写入的块
+        size_t newBytes = 0;      // 新写入的块字节数
+    };
+
+    // 每个槽位最多保留的历史快照数，超出时删除最旧的条目并回收不再引用的数据块
+    static constexpr size_t MAX_ENTRIES = 100;
+
+    // 切块参数：最小 512 字节，最大 8KB，滚动哈希低 10 位全 0 时切分（平均约 1.5KB）
+    // 最大块不能太大：一两万字节的小存档只切出一块时，每次保存都要整个重写
+    static constexpr size_t WINDOW = 256;
+    static constexpr size_t MIN_CHUNK = 512;
+    static constexpr size_t MAX_CHUNK = 8 * 1024;
+    static constexpr uint64_t BOUNDARY_MASK = (1u << 10) - 1;
+
+    static string historyDir(const string& slotName) {
+        return "saves/history/" + slotName;
+    }
+
+    // 把已写好的快照文件存入历史；失败时历史保持原样
+    static bool add(const string& slotName, const string& snapshotFile, const string& label,
+                    const string& playerName, int exp, size_t itemCount, SaveFormat format,
+                    AddStats* stats = nullptr) {
+        string dir = historyDir(slotName);
+        error_code ec;
+        filesystem::create_directories(dir + "/chunks", ec);
+        if (ec) return false;
+
+        FILE* f = fopen(snapshotFile.c_str(), "rb");
+        if (!f) return false;
+
+        AddStats local;
+        AddStats& s = stats ? *stats : local;
+        s = AddStats();
+        string manifest;
+        string chunk;
+        chunk.reserve(MAX_CHUNK);
+        size_t size = 0;
+        uint32_t crc = 0;
+        bool ok = true;
+
+        // 边读边切块，内存占用与快照大小无关
+        auto finishChunk = [&]() {
+            if (!ok || chunk.empty()) return;
+            string key = chunkKey(chunk);
+            string path = chunkPath(slotName, key);
+            // 已有同名块时至少核对大小，断电留下的截断块会被重写
+            size_t existing;
+            if (!SaveIO::fileSize(path, existing) || existing != chunk.size()) {
+                ok = writeChunk(path, chunk);
+                s.newChunks++;
+                s.newBytes += chunk.size();
+            }
+            manifest += key;
+            manifest += '\n';
+            s.chunks++;
+            chunk.clear();
+        };
+
+        // buzhash: 每进一个字节整体循环左移 1 位；窗口为 256 字节，移出窗口的字节已循环 256 位（即原位），直接异或掉
+        const uint64_t* table = byteTable();
+        uint64_t hash = 0;
+        unsigned char buffer[64 * 1024];
+        size_t n;
+        while (ok && (n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            crc = Checksum::crc32c(buffer, n, crc);
+            size += n;
+            for (size_t i = 0; i < n; i++) {
+                chunk += static_cast<char>(buffer[i]);
+                hash = ((hash << 1) | (hash >> 63)) ^ table[buffer[i]];
+                if (chunk.size() > WINDOW) {
+                    hash ^= table[static_cast<unsigned char>(chunk[chunk.size() - 1 - WINDOW])];
+                }
+                if ((chunk.size() >= MIN_CHUNK && (hash & BOUNDARY_MASK) == 0) || chunk.size() >= MAX_CHUNK) {
+                    finishChunk();
+                    hash = 0;
+                }
+            }
+        }
+        fclose(f);
+        finishChunk();
+        if (!ok) return false;
+
+        vector<Entry> entries = list(slotName);
+        Entry entry;
+        entry.id = entries.empty() ? 1 : entries.back().id + 1;
+        entry.savedAt = static_cast<long long>(time(nullptr));
+        entry.label = label;
+        entry.playerName = playerName;
+        entry.exp = exp;
+        entry.itemCount = itemCount;
+        entry.format = format;
+        entry.size = size;
+        entry.checksum = crc;
+        entry.chunkCount = s.chunks;
+        if (!SaveIO::atomicWrite(manifestPath(slotName, entry.id), manifest)) return false;
+
+        entries.push_back(entry);
+        vector<Entry> expired;
+        if (entries.size() > MAX_ENTRIES) {
+            size_t excess = entries.size() - MAX_ENTRIES;
+            expired.assign(entries.begin(), entries.begin() + excess);
+            entries.erase(entries.begin(), entries.begin() + excess);
+        }
+        if (!writeIndex(slotName, entries)) {
+            SaveIO::removeFile(manifestPath(slotName, entry.id));
+            return false;
+        }
+        if (!expired.empty()) {
+            for (const Entry& old : expired) SaveIO::removeFile(manifestPath(slotName, old.id));
+            collectGarbage(slotName, entries);
+        }
+        return true;
+    }
+
+    // 按时间顺序（旧 -> 新）列出历史条目；没有历史时返回空列表
+    static vector<Entry> list(const string& slotName) {
+        vector<Entry> entries;
+        string data;
+        if (!SaveIO::readFile(indexPath(slotName), data)) return entries;
+        json j = json::parse(data, nullptr, false);
+        if (j.is_discarded() || !j.is_object() || !j.contains("entries") || !j["entries"].is_array()) {
+            return entries;
+        }
+        for (const json& e : j["entries"]) {
+            if (!e.is_object() || !e.contains("id")) continue;
+            Entry entry;
+            entry.id = e.value("id", 0);
+            entry.savedAt = e.value("saved_at", 0LL);
+            entry.label = e.value("label", "");
+            entry.playerName = e.value("player_name", "");
+            entry.exp = e.value("exp", 0);
+            entry.itemCount = e.value("item_count", static_cast<size_t>(0));
+            entry.format = e.value("format", "json") == "msgpack" ? SaveFormat::MSGPACK : SaveFormat::JSON;
+            entry.size = e.value("size", static_cast<size_t>(0));
+            entry.checksum = e.value("checksum", 0u);
+            entry.chunkCount = e.value("chunks", static_cast<size_t>(0));
+            entries.push_back(entry);
+        }
+        return entries;
+    }
+
+    static bool find(const string& slotName, int id, Entry& out) {
+        for (const Entry& entry : list(slotName)) {
+            if (entry.id == id) {
+                out = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 把历史快照重新拼回 targetFile（原子替换）；任何数据块缺失或校验不符时返回 false，原文件不变
+    static bool restore(const string& slotName, int id, const string& targetFile, string& error) {
+        Entry entry;
+        if (!find(slotName, id, entry)) {
+            error = "找不到历史记录 #" + to_string(id);
+            return false;
+        }
+        string manifest;
+        if (!SaveIO::readFile(manifestPath(slotName, id), manifest)) {
+            error = "历史记录的清单丢失";
+            return false;
+        }
+
+        SaveIO::AtomicFile out(targetFile);
+        if (!out.isOpen()) {
+            error = "无法写入存档文件";
+            return false;
+        }
+        size_t size = 0;
+        uint32_t crc = 0;
+        size_t start = 0;
+        string chunk;
+        while (start < manifest.size()) {
+            size_t end = manifest.find('\n', start);
+            if (end == string::npos) end = manifest.size();
+            string key = manifest.substr(start, end - start);
+            start = end + 1;
+            if (key.empty()) continue;
+            if (!SaveIO::readFile(chunkPath(slotName, key), chunk) || chunkKey(chunk) != key) {
+                error = "数据块 " + key + " 缺失或已损坏";
+                return false;
+            }
+            out.write(chunk);
+            crc = Checksum::crc32c(chunk.data(), chunk.size(), crc);
+            size += chunk.size();
+        }
+        if (size != entry.size || crc != entry.checksum) {
+            error = "快照校验和不一致";
+            return false;
+        }
+        if (!out.commit()) {
+            error = "存档文件写入失败";
+            return false;
+        }
+        return true;
+    }
+
+    // 历史占用的磁盘空间（数据块 + 清单 + 索引）
+    static size_t diskUsage(const string& slotName) {
+        size_t total = 0;
+        error_code ec;
+        for (filesystem::recursive_directory_iterator it(historyDir(slotName), ec), end;
+             !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) total += static_cast<size_t>(it->file_size(ec));
+        }
+        return total;
+    }
+
+    static void clear(const string& slotName) {
+        error_code ec;
+        filesystem::remove_all(historyDir(slotName), ec);
+    }
+
+    // 显示用的保存时间，例如 "2025-12-28 21:05:09"
+    static string timeText(long long savedAt) {
+        time_t t = static_cast<time_t>(savedAt);
+        char buffer[32];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&t));
+        return buffer;
+    }
+
+private:
+    static string indexPath(const string& slotName) {
+        return historyDir(slotName) + "/index.json";
+    }
+
+    static string manifestPath(const string& slotName, int id) {
+        return historyDir(slotName) + "/" + to_string(id) + ".manifest";
+    }
+
+    static string chunkPath(const string& slotName, const string& key) {
+        return historyDir(slotName) + "/chunks/" + key;
+    }
+
+    // 滚动哈希用的 256 个随机数（固定种子，保证每次运行切块结果相同）
+    static const uint64_t* byteTable() {
+        static const struct Table {
+            uint64_t entries[256];
+            Table() {
+                uint64_t x = 0x436F726552656667ull;
+                for (int i = 0; i < 256; i++) {
+                    // splitmix64
+                    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    entries[i] = z ^ (z >> 31);
+                }
+            }
+        } instance;
+        return instance.entries;
+    }
+
+    // 块名: 64 位 FNV-1a + CRC32C + 长度（十六进制），同名即视为内容相同
+    static string chunkKey(const string& chunk) {
+        uint64_t fnv = 0xCBF29CE484222325ull;
+        for (unsigned char c : chunk) {
+            fnv ^= c;
+            fnv *= 0x100000001B3ull;
+        }
+        char key[48];
+        snprintf(key, sizeof(key), "%016llx%08x%x", static_cast<unsigned long long>(fnv),
+                 Checksum::crc32c(chunk), static_cast<unsigned>(chunk.size()));
+        return key;
+    }
+
+    // 写临时文件并 fsync 后再重命名（SaveIO::atomicWrite），清单和索引写入时引用的块都已落盘
+    static bool writeChunk(const string& path, const string& chunk) {
+        return SaveIO::atomicWrite(path, chunk);
+    }
+
+    static bool writeIndex(const string& slotName, const vector<Entry>& entries) {
+        json list = json::array();
+        for (const Entry& entry : entries) {
+            list.push_back({
+                {"id", entry.id},
+                {"saved_at", entry.savedAt},
+                {"label", entry.label},
+                {"player_name", entry.playerName},
+                {"exp", entry.exp},
+                {"item_count", entry.itemCount},
+                {"format", entry.format == SaveFormat::MSGPACK ? "msgpack" : "json"},
+                {"size", entry.size},
+                {"checksum", entry.checksum},
+                {"chunks", entry.chunkCount}
+            });
+        }
+        json j;
+        j["entries"] = list;
+        return SaveIO::atomicWrite(indexPath(slotName), j.dump(1));
+    }
+
+    // 删除剩余清单都不再引用的数据块（也清理中途失败留下的孤立块和临时文件）
+    static void collectGarbage(const string& slotName, const vector<Entry>& entries) {
+        unordered_set<string> referenced;
+        for (const Entry& entry : entries) {
+            string manifest;
+            if (!SaveIO::readFile(manifestPath(slotName, entry.id), manifest)) continue;
+            size_t start = 0;
+            while (start < manifest.size()) {
+                size_t end = manifest.find('\n', start);
+                if (end == string::npos) end = manifest.size();
+                if (end > start) referenced.insert(manifest.substr(start, end - start));
+                start = end + 1;
+            }
+        }
+        error_code ec;
+        vector<filesystem::path> unused;
+        for (filesystem::directory_iterator it(historyDir(slotName) + "/chunks", ec), end;
+             !ec && it != end; it.increment(ec)) {
+            if (!referenced.count(it->path().filename().string())) unused.push_back(it->path());
+        }
+        for (const auto& path : unused) filesystem::remove(path, ec);
+    }
+};
+
+#endif // SAVE_HISTORY_H
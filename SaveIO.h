@@ -0,0 +1,190 @@
+/**
+ * 文件名: SaveIO.h
+ * 职责: 存档底层文件操作 - 原子写入、日志追加、整文件读取
+ *
+ * 原子写入流程: 写入 <文件>.tmp -> fflush + fsync -> 重命名覆盖原文件。
+ * 任何时刻崩溃，磁盘上要么是完整的旧文件，要么是完整的新文件。
+ * 内容很大时用 AtomicFile 边生成边写入，不必先在内存中拼出整个文件。
+ */
+
+#ifndef SAVE_IO_H
+#define SAVE_IO_H
+
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>        // _commit / _fileno
+#else
+#include <unistd.h>    // fsync
+#include <fcntl.h>
+#endif
+
+using namespace std;
+
+class SaveIO {
+private:
+    // 把已写入的数据刷到磁盘
+    static bool syncFile(FILE* f) {
+        if (fflush(f) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(f)) == 0;
+#else
+        return fsync(fileno(f)) == 0;
+#endif
+    }
+
+    // POSIX 下重命名后还要同步所在目录，保证目录项本身落盘
+    static void syncParentDir(const string& path) {
+#ifndef _WIN32
+        size_t slash = path.find_last_of('/');
+        string dir = slash == string::npos ? "." : path.substr(0, slash);
+        int fd = open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    static bool replaceFile(const string& from, const string& to) {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+public:
+    // 流式原子写入：写入 <文件>.tmp，commit() 时同步并重命名；没有 commit 就销毁则删除临时文件
+    class AtomicFile {
+    private:
+        string path;
+        string tmp;
+        FILE* f = nullptr;
+        bool ok = true;
+
+    public:
+        static constexpr size_t BUFFER_SIZE = 256 * 1024;
+
+        explicit AtomicFile(const string& target) : path(target), tmp(target + ".tmp") {
+            f = fopen(tmp.c_str(), "wb");
+            if (f) setvbuf(f, nullptr, _IOFBF, BUFFER_SIZE);
+        }
+
+        AtomicFile(const AtomicFile&) = delete;
+        AtomicFile& operator=(const AtomicFile&) = delete;
+
+        ~AtomicFile() {
+            if (f) {
+                fclose(f);
+                remove(tmp.c_str());
+            }
+        }
+
+        bool isOpen() const {
+            return f != nullptr;
+        }
+
+        void write(const void* data, size_t size) {
+            if (ok && fwrite(data, 1, size, f) != size) ok = false;
+        }
+
+        void write(const string& data) {
+            write(data.data(), data.size());
+        }
+
+        long tell() {
+            return ftell(f);
+        }
+
+        // 回到已写入的位置改写（如分段头中的长度），之后需 seek 回末尾
+        void seek(long pos) {
+            if (ok && fseek(f, pos, SEEK_SET) != 0) ok = false;
+        }
+
+        void seekEnd() {
+            if (ok && fseek(f, 0, SEEK_END) != 0) ok = false;
+        }
+
+        bool commit() {
+            if (!f) return false;
+            bool synced = ok && syncFile(f);
+            fclose(f);
+            f = nullptr;
+            if (!synced || !replaceFile(tmp, path)) {
+                remove(tmp.c_str());
+                return false;
+            }
+            syncParentDir(path);
+            return true;
+        }
+    };
+
+    // 原子写入整个文件
+    static bool atomicWrite(const string& path, const string& data) {
+        string tmp = path + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+
+        bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+        ok = syncFile(f) && ok;
+        fclose(f);
+
+        if (!ok || !replaceFile(tmp, path)) {
+            remove(tmp.c_str());
+            return false;
+        }
+        syncParentDir(path);
+        return true;
+    }
+
+    // 向日志文件追加一行并同步到磁盘（崩溃时最多丢失正在写的这一行）
+    static bool appendLine(const string& path, const string& line) {
+        FILE* f = fopen(path.c_str(), "ab");
+        if (!f) return false;
+        bool ok = fwrite(line.data(), 1, line.size(), f) == line.size();
+        ok = fputc('\n', f) != EOF && ok;
+        ok = syncFile(f) && ok;
+        fclose(f);
+        return ok;
+    }
+
+    // 读取整个文件，文件不存在时返回 false
+    static bool readFile(const string& path, string& out) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        out.clear();
+        char buffer[64 * 1024];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            out.append(buffer, n);
+        }
+        fclose(f);
+        return true;
+    }
+
+    static bool fileExists(const string& path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0;
+    }
+
+    // 读取文件大小，文件不存在时返回 false
+    static bool fileSize(const string& path, size_t& size) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+        size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    static void removeFile(const string& path) {
+        remove(path.c_str());
+    }
+};
+
+#endif // SAVE_IO_H
@@ -0,0 +1,316 @@
+/**
+ * 文件名: SaveJournal.h
+ * 职责: 存档日志 (write-ahead journal) - 两次完整快照之间只追加小的变更记录
+ *
+ * 每个槽位一个日志文件 saves/save_slot_<槽位名>.journal，每次保存的全部变更写成一行：
+ *   {"g":3,"ops":[{"op":"exp","v":1200},{"op":"shops","v":{...}}]}
+ * 变更类型：
+ *   {"op":"exp","v":1200}                      EXP 变为 v
+ *   {"op":"add","tid":101,"lv":1,"rar":1}      背包末尾新增装备
+ *   {"op":"remove","idx":4}                    移除背包第 idx 件装备
+ *   {"op":"level","idx":2,"lv":3}              第 idx 件装备等级变为 lv
+ *   {"op":"equip","armor_id":201,"weapon_ids":[101]}
+ *   {"op":"shops","v":{"base_shop":...,"campfire_shop":...}}   商店状态整体替换
+ * "g" 是日志所属的快照代数：快照中记录 journal_gen，读档时只重放代数相同的条目，
+ * 因此"新快照已写入、旧日志还没删除"时崩溃也不会重复应用旧日志。
+ * 日志最后一行可能因崩溃而不完整，读取时遇到无法解析的行即停止——
+ * 同一次保存的玩家和商店变更在同一行中，要么全部重放，要么全部丢弃。
+ * 旧版日志每行一条变更（{"g":3,"op":...}），同样可以读取。
+ *
+ * 计算差异时只看界面操作报告的背包位置（移除、升级），新增的装备总在背包末尾，按件数即可得知，
+ * 每次保存的耗时只与变化的件数有关；有未报告的变化时才完整比较整个背包。
+ */
+
+#ifndef SAVE_JOURNAL_H
+#define SAVE_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#include "json.hpp"
+#include "GameCore.h"
+#include "SaveIO.h"
+#include "SaveSnapshot.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+class SaveJournal {
+private:
+    string slot;
+    int generation = 0;
+    int entryCount = 0;
+
+    // 上次提交保存（快照 + 日志）后的状态，用于计算差异，同时作为后台保存的快照来源
+    PlayerSnapshot state;
+
+    // 上次保存之后界面操作报告的背包变化（脏集合）
+    vector<size_t> removedItems;  // 依次移除的位置（移除当时的下标）
+    vector<size_t> leveledItems;  // 等级可能变化的位置（当前下标）
+    bool changesKnown = true;     // false: 有无法报告的变化，完整比较整个背包
+
+    void clearChanges() {
+        removedItems.clear();
+        leveledItems.clear();
+        changesKnown = true;
+    }
+
+    // 按报告的变化更新：只访问被移除、改过等级的位置和末尾新增的装备，与背包大小无关
+    // 背包与报告不符（有未报告的变化）时返回 false，由调用方改写完整快照
+    bool applyReportedChanges(const vector<Equipment*>& inventory, vector<json>& ops) {
+        size_t base = state.items.size();  // 背包开头仍是上次记录的装备，共 base 件
+        for (size_t idx : removedItems) {
+            if (idx >= base) continue;     // 移除的是本次新增、还没记录的装备
+            ops.push_back({{"op", "remove"}, {"idx", idx}});
+            state.items.remove(idx);
+            base--;
+        }
+        if (base > inventory.size()) return false;
+        if (base > 0 && inventory[base - 1] != state.items.at(base - 1).ptr) return false;
+
+        sort(leveledItems.begin(), leveledItems.end());
+        leveledItems.erase(unique(leveledItems.begin(), leveledItems.end()), leveledItems.end());
+        for (size_t k : leveledItems) {
+            if (k >= base) continue;       // 新增的装备按当前等级整体记录
+            int lv = inventory[k]->getLevel();
+            if (lv != state.items.at(k).lv) {
+                ops.push_back({{"op", "level"}, {"idx", k}, {"lv", lv}});
+                state.items.setLevel(k, lv);
+            }
+        }
+
+        for (size_t i = base; i < inventory.size(); i++) {
+            Equipment* eq = inventory[i];
+            ops.push_back({{"op", "add"}, {"tid", eq->getId()}, {"lv", eq->getLevel()},
+                           {"rar", static_cast<int>(eq->getRarity())}});
+            state.items.push(InventoryImage::recordOf(eq));
+        }
+        return true;
+    }
+
+    // 完整比较整个背包（有未报告的变化时使用）
+    // 只能表达"删除若干件 + 原地改等级 + 末尾追加"，其他变化（如背包重排）返回 false
+    bool diffInventory(const vector<Equipment*>& inventory, vector<json>& ops) {
+        unordered_map<const Equipment*, const Equipment*> current;
+        for (auto eq : inventory) current[eq] = eq;
+
+        // 1. 删除：旧列表中已不存在的装备（地址被复用但内容不同也视为删除）
+        vector<const Equipment*> kept;
+        vector<int> keptLevels;
+        vector<size_t> removals;
+        state.items.forEach([&](const ItemRecord& item) {
+            auto it = current.find(item.ptr);
+            bool same = it != current.end() && it->second->getId() == item.tid &&
+                        static_cast<int>(it->second->getRarity()) == item.rar;
+            if (same) {
+                kept.push_back(item.ptr);
+                keptLevels.push_back(item.lv);
+            } else {
+                removals.push_back(kept.size());
+            }
+        });
+
+        // 2. 保留的装备必须按原顺序位于背包开头
+        if (kept.size() > inventory.size()) return false;
+        for (size_t i = 0; i < kept.size(); i++) {
+            if (inventory[i] != kept[i]) return false;
+        }
+
+        for (size_t idx : removals) {
+            ops.push_back({{"op", "remove"}, {"idx", idx}});
+            state.items.remove(idx);
+        }
+
+        // 3. 等级变化
+        for (size_t k = 0; k < kept.size(); k++) {
+            if (inventory[k]->getLevel() != keptLevels[k]) {
+                ops.push_back({{"op", "level"}, {"idx", k}, {"lv", inventory[k]->getLevel()}});
+                state.items.setLevel(k, inventory[k]->getLevel());
+            }
+        }
+
+        // 4. 末尾新增
+        for (size_t i = kept.size(); i < inventory.size(); i++) {
+            Equipment* eq = inventory[i];
+            ops.push_back({{"op", "add"}, {"tid", eq->getId()}, {"lv", eq->getLevel()},
+                           {"rar", static_cast<int>(eq->getRarity())}});
+            state.items.push(InventoryImage::recordOf(eq));
+        }
+        return true;
+    }
+
+    static int equipmentId(const Equipment* eq) {
+        return eq ? eq->getId() : -1;
+    }
+
+    static vector<int> idsOf(const vector<Equipment*>& list) {
+        vector<int> ids;
+        for (auto eq : list) ids.push_back(eq->getId());
+        return ids;
+    }
+
+public:
+    // 日志条目超过该数量时改写完整快照，避免读档时重放过多条目
+    static constexpr int COMPACT_THRESHOLD = 256;
+
+    static string journalPath(const string& slotName) {
+        return "saves/save_slot_" + slotName + ".journal";
+    }
+
+    // 整体记录当前状态（读档或无法增量表达的变化之后调用）
+    void reset(const string& slotName, int gen, int entries, const string& name,
+               const vector<Equipment*>& inventory, int playerExp,
+               Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons, const json& shops) {
+        slot = slotName;
+        generation = gen;
+        entryCount = entries;
+        state.playerName = name;
+        state.exp = playerExp;
+        state.armorId = equipmentId(equippedArmor);
+        state.weaponIds = idsOf(equippedWeapons);
+        state.items.assign(inventory);
+        state.shops = shops;
+        clearChanges();
+    }
+
+    // 界面操作报告背包变化（在下一次 record 时使用）
+    // 移除第 idx 件装备（移除前调用，idx 为当时的下标）
+    void noteRemoved(size_t idx) {
+        removedItems.push_back(idx);
+        vector<size_t> shifted;
+        for (size_t k : leveledItems) {
+            if (k < idx) shifted.push_back(k);
+            else if (k > idx) shifted.push_back(k - 1);
+        }
+        leveledItems.swap(shifted);
+    }
+
+    // 第 idx 件装备的等级变了
+    void noteLevelChanged(size_t idx) {
+        leveledItems.push_back(idx);
+    }
+
+    // 背包有无法逐项报告的变化（例如整体替换、重排），下次 record 完整比较
+    void noteUnknownChanges() {
+        changesKnown = false;
+    }
+
+    bool tracks(const string& slotName) const {
+        return slot == slotName;
+    }
+
+    int getGeneration() const {
+        return generation;
+    }
+
+    int getEntryCount() const {
+        return entryCount;
+    }
+
+    bool needsCompaction() const {
+        return entryCount >= COMPACT_THRESHOLD;
+    }
+
+    // 当前状态的快照（与背包大小无关的 O(1) 复制）
+    const PlayerSnapshot& snapshot() const {
+        return state;
+    }
+
+    // 开始新的快照代数：之后的日志条目属于即将写入的新快照
+    void startGeneration() {
+        generation++;
+        entryCount = 0;
+    }
+
+    // 计算当前状态与上次记录状态的差异，生成日志条目并增量更新记录的状态
+    // 背包只比较报告过的位置（见 noteRemoved / noteLevelChanged），没有报告时完整比较；
+    // 无法用日志表达的变化（如改名、背包重排）返回 false，需写完整快照
+    bool record(const string& name, const vector<Equipment*>& inventory, int playerExp,
+                Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons,
+                const json& shops, vector<json>& ops) {
+        if (name != state.playerName) return false;
+
+        bool inventoryOk = changesKnown ? applyReportedChanges(inventory, ops) : diffInventory(inventory, ops);
+        clearChanges();
+        if (!inventoryOk) return false;
+
+        if (playerExp != state.exp) {
+            ops.push_back({{"op", "exp"}, {"v", playerExp}});
+            state.exp = playerExp;
+        }
+
+        vector<int> newWeaponIds = idsOf(equippedWeapons);
+        if (equipmentId(equippedArmor) != state.armorId || newWeaponIds != state.weaponIds) {
+            ops.push_back({{"op", "equip"}, {"armor_id", equipmentId(equippedArmor)},
+                           {"weapon_ids", newWeaponIds}});
+            state.armorId = equipmentId(equippedArmor);
+            state.weaponIds = newWeaponIds;
+        }
+
+        if (shops != state.shops) {
+            ops.push_back({{"op", "shops"}, {"v", shops}});
+            state.shops = shops;
+        }
+        return true;
+    }
+
+    // 把一次保存的全部变更打包成一行并标上当前代数
+    string stamp(const vector<json>& ops) {
+        json line;
+        line["g"] = generation;
+        line["ops"] = ops;
+        entryCount += ops.size();
+        return line.dump();
+    }
+
+    // 读取属于指定快照代数的日志条目（遇到不完整的行即停止）
+    // intact 为 false 表示末尾有残缺的行，调用方应重写日志，否则之后追加的条目会接在残行后面
+    static vector<json> readEntries(const string& slotName, int gen, bool& intact) {
+        vector<json> entries;
+        intact = true;
+        string content;
+        if (!SaveIO::readFile(journalPath(slotName), content)) return entries;
+
+        istringstream in(content);
+        string line;
+        while (getline(in, line)) {
+            if (line.empty()) continue;
+            json entry = json::parse(line, nullptr, false);
+            if (entry.is_discarded() || !entry.is_object()) {
+                intact = false;
+                break;
+            }
+            if (entry.value("g", -1) != gen) continue;
+            if (entry.contains("ops")) {
+                json& ops = entry["ops"];
+                bool valid = ops.is_array();
+                for (size_t i = 0; valid && i < ops.size(); i++) valid = ops[i].is_object();
+                if (!valid) {
+                    intact = false;
+                    break;
+                }
+                for (auto& op : ops) {
+                    op["g"] = gen;
+                    entries.push_back(op);
+                }
+            } else {
+                entries.push_back(entry);
+            }
+        }
+        return entries;
+    }
+
+    // 只保留有效条目重写日志
+    static bool rewrite(const string& slotName, const vector<json>& entries) {
+        string lines;
+        for (const json& entry : entries) {
+            lines += entry.dump();
+            lines += '\n';
+        }
+        return SaveIO::atomicWrite(journalPath(slotName), lines);
+    }
+};
+
+#endif // SAVE_JOURNAL_H
@@ -7,10 +7,34 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <algorithm>
+#include <sstream>
+#include <climits>
+#include <cctype>
+#include <filesystem>  // 扫描 saves 文件夹中的槽位
+#include <atomic>
+#include <ctime>
 #include <sys/stat.h>  // 用于检查文件夹是否存在
+#ifdef _WIN32
 #include <direct.h>    // Windows 下创建文件夹
+#endif
 #include "json.hpp" // 确保有 nlohmann/json
 #include "GameCore.h"
+#include "DataLoader.h"   // 装备/怪物工厂与 Monster 定义
+#include "DataValidator.h"
+#include "ContentPacks.h"   // 按需加载的内容包
+#include "SaveIO.h"         // 原子写入
+#include "SaveJournal.h"    // 存档日志
+#include "SaveFormat.h"     // JSON / 二进制存档编码
+#include "SlotMeta.h"       // 槽位元数据（存档列表、快速校验）
+#include "SaveSnapshot.h"   // 写时复制的玩家状态快照
+#include "SaveWorker.h"     // 后台存档线程
+#include "SaveStream.h"     // 流式读写存档
+#include "SaveHistory.h"    // 去重的历史快照（回滚）
+#include "SaveSchema.h"     // 存档结构版本与迁移
+#ifdef EMBEDDED_CONTENT
+#include "EmbeddedContent.h"  // 编译期内嵌的内容表
+#endif
 
 using json = nlohmann::json;
 using namespace std;
@@ -22,7 +46,135 @@ private:
     static map<int, Equipment*> itemLibrary;
     static vector<Monster> monsterLibrary;
 
+    // 当前已加载槽位的存档日志
+    static SaveJournal journal;
+    // 当前已加载槽位的存档格式（读档时自动识别）
+    static SaveFormat slotFormat;
+    // 当前已加载槽位的元数据（只在存档线程中访问）
+    static SlotMeta slotMeta;
+    // 后台写入失败时置位，下一次保存改写完整快照
+    static atomic<bool> saveFailed;
+    // 上一次提交完整快照的时间，用于定时改写快照
+    static time_t lastSnapshotTime;
+    // 读档时合并了旧版商店文件或丢弃了损坏的分段，下一次保存写入完整快照
+    static bool rewriteSnapshot;
+
+    // 更新元数据中的玩家信息并写入 .meta 文件（快照字段由调用方设置，在存档线程中运行）
+    static void writeSlotMeta(const string& slotName, const string& playerName, int playerExp,
+                              size_t itemCount, SaveFormat format) {
+        slotMeta.playerName = playerName;
+        slotMeta.exp = playerExp;
+        slotMeta.itemCount = itemCount;
+        slotMeta.savedAt = time(nullptr);
+        slotMeta.format = format;
+        if (!slotMeta.write(slotName)) {
+            cout << "[警告] 存档元数据写入失败，槽位列表可能显示旧信息。" << endl;
+        }
+    }
+
+    // 只根据快照内容重建元数据（旧存档、元数据丢失或快照被手动修改时）
+    static SlotMeta metaFromSnapshot(const SaveReadResult& save) {
+        SlotMeta meta;
+        meta.playerName = save.fields.value("player_name", "");
+        meta.exp = save.fields.value("exp", 0);
+        meta.itemCount = save.itemCount;
+        meta.format = save.format;
+        meta.setSnapshot(save.fileSize, save.fileCrc);
+        return meta;
+    }
+
+    // 启动检查：旧版本存档只在内存中迁移后检查字段，真正的升级在读档时进行
+    static bool checkSchema(const json& fields) {
+        if (SaveSchema::isCurrent(fields)) return SaveSchema::isComplete(fields);
+        json migrated = fields;
+        vector<string> applied;
+        string error;
+        return SaveSchema::migrate(migrated, SaveSchema::Context(), applied, error) &&
+               SaveSchema::isComplete(migrated);
+    }
+
+    // 只需要元数据时读取快照：装备只计数，不创建对象
+    static bool scanSnapshot(const string& slotName, SaveReadResult& save) {
+        return SaveReader::read(slotFile(slotName), save, [](int, int, int) {});
+    }
+
+    static constexpr size_t MAX_SLOT_NAME_LENGTH = 64;
+
+    static string slotFile(const string& slotName) {
+        return "saves/save_slot_" + slotName + ".json";
+    }
+
+    // 旧版单独保存的商店状态，读档时合并进存档，写入新快照后删除
+    static string legacyShopFile(const string& slotName) {
+        return "saves/shop_slot_" + slotName + ".json";
+    }
+
+    // 把一条日志应用到读档结果上；条目无法应用时返回 false
+    static bool applyJournalEntry(const json& entry, vector<Equipment*>& inventory, int& playerExp,
+                                  int& equippedArmorId, vector<int>& equippedWeaponIds, json& shops) {
+        string op = entry.value("op", "");
+        if (op == "exp") {
+            playerExp = entry.value("v", playerExp);
+        } else if (op == "add") {
+            Equipment* prototype = getItemTemplate(entry.value("tid", -1));
+            if (!prototype) return false;
+            inventory.push_back(prototype->clone(prototype->getName(), entry.value("lv", 1)));
+        } else if (op == "remove") {
+            int idx = entry.value("idx", -1);
+            if (idx < 0 || idx >= (int)inventory.size()) return false;
+            delete inventory[idx];
+            inventory.erase(inventory.begin() + idx);
+        } else if (op == "level") {
+            int idx = entry.value("idx", -1);
+            if (idx < 0 || idx >= (int)inventory.size()) return false;
+            Equipment* prototype = getItemTemplate(inventory[idx]->getId());
+            if (!prototype) return false;
+            delete inventory[idx];
+            inventory[idx] = prototype->clone(prototype->getName(), entry.value("lv", 1));
+        } else if (op == "equip") {
+            equippedArmorId = entry.value("armor_id", -1);
+            equippedWeaponIds.clear();
+            if (entry.contains("weapon_ids")) {
+                for (auto& weaponId : entry["weapon_ids"]) {
+                    equippedWeaponIds.push_back(weaponId);
+                }
+            }
+        } else if (op == "shops") {
+            if (!entry.contains("v") || !entry["v"].is_object()) return false;
+            shops = entry["v"];
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // 读档后记录已落盘的状态（装备配置按 id 还原成与 main 相同的装备对象）
+    static void resetJournal(const string& slotName, int gen, int entries, const string& playerName,
+                             const vector<Equipment*>& inventory, int playerExp,
+                             int equippedArmorId, const vector<int>& equippedWeaponIds, const json& shops) {
+        Equipment* armor = nullptr;
+        vector<Equipment*> weapons;
+        for (auto item : inventory) {
+            if (item->getId() == equippedArmorId && dynamic_cast<Armor*>(item)) {
+                armor = item;
+                break;
+            }
+        }
+        for (int weaponId : equippedWeaponIds) {
+            for (auto item : inventory) {
+                if (item->getId() == weaponId) {
+                    if (dynamic_cast<Weapon*>(item)) weapons.push_back(item);
+                    break;
+                }
+            }
+        }
+        journal.reset(slotName, gen, entries, playerName, inventory, playerExp, armor, weapons, shops);
+    }
+
 public:
+    // 存档菜单每页显示的槽位数
+    static constexpr int SLOT_PAGE_SIZE = 10;
+
     // 确保 saves 文件夹存在
     static void ensureSavesFolderExists() {
         struct stat info;
@@ -42,23 +194,179 @@ public:
         }
     }
     
-    // 获取装备库的访问方法
+    // 获取装备库的访问方法（使用内容包时按需加载包含该 id 的包）
     static Equipment* getItemTemplate(int id) {
-        if (itemLibrary.count(id)) {
-            return itemLibrary[id];
+        auto it = itemLibrary.find(id);
+        if (it == itemLibrary.end() && ContentPacks::isActive()) {
+            ContentPacks::ensureEquipmentForId(id);
+            it = itemLibrary.find(id);
         }
-        return nullptr;
+        return it != itemLibrary.end() ? it->second : nullptr;
     }
     
     // 获取所有装备模板
     static vector<Equipment*> getAllEquipmentTemplates() {
+        if (ContentPacks::isActive()) {
+            ContentPacks::ensureAllEquipment();
+        }
         vector<Equipment*> templates;
         for (auto& pair : itemLibrary) {
             templates.push_back(pair.second);
         }
         return templates;
     }
+
+    // 获取某个势力的所有装备模板（只加载该势力的内容包）
+    static vector<Equipment*> getEquipmentTemplatesByFaction(string_view faction) {
+        if (ContentPacks::isActive()) {
+            ContentPacks::ensureFaction(faction);
+        }
+        vector<Equipment*> templates;
+        for (auto& pair : itemLibrary) {
+            if (pair.second->getFaction() == faction) {
+                templates.push_back(pair.second);
+            }
+        }
+        return templates;
+    }
+
+    // 获取所有怪物模板
+    static const vector<Monster>& getAllMonsters() {
+        return monsterLibrary;
+    }
+
+    // 获取某个冒险难度可出现的怪物（使用内容包时按需加载对应等级的怪物包）
+    static vector<Monster> getMonstersForDifficulty(int difficulty) {
+        if (ContentPacks::isActive()) {
+            return ContentPacks::getMonstersForDifficulty(difficulty);
+        }
+        return monsterLibrary;
+    }
+
+    // 预先并行加载全部内容包（服务器模式：启动耗时约等于最大的单个包）
+    static void preloadContent() {
+        if (ContentPacks::isActive()) {
+            ContentPacks::preloadAll();
+        }
+    }
+
+    // 0. 初始化内容：优先使用内容包清单（按需加载），没有清单时整体加载 gamedata.json
+    static void initContent(const string& manifestFile, const string& dbFile) {
+        if (ContentPacks::loadManifest(manifestFile, itemLibrary)) {
+            cout << "[系统] 内容清单加载完毕，共 " << ContentPacks::packCount()
+                 << " 个内容包（按需加载）。" << endl;
+            return;
+        }
+        initGameData(dbFile);
+    }
+
+    // 校验内容包的合并结果与加载顺序无关：按清单顺序和倒序各逐个加载一遍，得到的模板库和怪物必须完全相同；
+    // 清单列出了 ids 时，同时检查按 id 查找装备只加载该 id 所属的一个包
+    static bool verifyContentPacks(const string& manifestFile) {
+        map<int, Equipment*> forward, backward;
+        vector<Monster> forwardMonsters, backwardMonsters;
+        bool loaded = loadPacksInOrder(manifestFile, false, forward, forwardMonsters) &&
+                      loadPacksInOrder(manifestFile, true, backward, backwardMonsters);
+
+        int mismatches = 0;
+        if (!loaded) {
+            cout << "[错误] 无法读取内容清单: " << manifestFile << endl;
+            mismatches++;
+        } else {
+            if (forward.size() != backward.size()) {
+                cout << "[校验] 装备数量与加载顺序有关: 顺序 " << forward.size() << " / 倒序 " << backward.size() << endl;
+                mismatches++;
+            }
+            for (auto& pair : forward) {
+                auto it = backward.find(pair.first);
+                if (it == backward.end() || !sameTemplate(pair.second, it->second)) {
+                    cout << "[校验] 装备模板与加载顺序有关: id " << pair.first << endl;
+                    mismatches++;
+                }
+            }
+            if (forwardMonsters.size() != backwardMonsters.size()) {
+                cout << "[校验] 怪物数量与加载顺序有关: 顺序 " << forwardMonsters.size()
+                     << " / 倒序 " << backwardMonsters.size() << endl;
+                mismatches++;
+            } else {
+                for (size_t i = 0; i < forwardMonsters.size(); i++) {
+                    const Monster& a = forwardMonsters[i];
+                    const Monster& b = backwardMonsters[i];
+                    if (a.id != b.id || a.name != b.name || a.hp != b.hp || a.atk != b.atk || a.exp != b.exp) {
+                        cout << "[校验] 怪物模板与加载顺序有关: id " << a.id << endl;
+                        mismatches++;
+                    }
+                }
+            }
+
+            // 逐个 id 从头加载，统计加载了几个包（加载过程的输出不显示）
+            ostringstream sink;
+            for (auto& pair : forward) {
+                map<int, Equipment*> single;
+                streambuf* console = cout.rdbuf(sink.rdbuf());
+                ContentPacks::loadManifest(manifestFile, single);
+                ContentPacks::ensureEquipmentForId(pair.first);
+                bool indexed = ContentPacks::hasIdIndex();
+                int loadedCount = ContentPacks::loadedPackCount();
+                ContentPacks::reset();
+                cout.rdbuf(console);
+                sink.str("");
+                for (auto& item : single) delete item.second;
+                if (indexed && loadedCount != 1) {
+                    cout << "[校验] 查找装备 id " << pair.first << " 加载了 " << loadedCount << " 个内容包" << endl;
+                    mismatches++;
+                }
+            }
+        }
+
+        for (auto& pair : forward) delete pair.second;
+        for (auto& pair : backward) delete pair.second;
+
+        if (mismatches == 0) {
+            cout << "[校验] 内容包按不同顺序加载的结果一致（装备 " << forward.size()
+                 << "，怪物 " << forwardMonsters.size() << "）。" << endl;
+        }
+        return mismatches == 0;
+    }
+
+    // 逐个加载清单中的全部包（reversed 为 true 时从最后一个包开始），结果放入 items / monsters（按 id 排序）
+    static bool loadPacksInOrder(const string& manifestFile, bool reversed, map<int, Equipment*>& items,
+                                 vector<Monster>& monsters) {
+        if (!ContentPacks::loadManifest(manifestFile, items)) return false;
+        int count = ContentPacks::packCount();
+        for (int k = 0; k < count; k++) {
+            ContentPacks::ensurePack(static_cast<size_t>(reversed ? count - 1 - k : k));
+        }
+        monsters = ContentPacks::getMonstersForDifficulty(INT_MAX);
+        sort(monsters.begin(), monsters.end(), [](const Monster& a, const Monster& b) { return a.id < b.id; });
+        ContentPacks::reset();
+        return true;
+    }
+
+    // 比较两个模板的全部字段
+    static bool sameTemplate(const Equipment* a, const Equipment* b) {
+        if (a->getId() != b->getId() || a->getName() != b->getName() ||
+            a->getRarity() != b->getRarity() || a->getFaction() != b->getFaction() ||
+            a->getLevel() != b->getLevel()) {
+            return false;
+        }
+        const Weapon* wa = dynamic_cast<const Weapon*>(a);
+        const Weapon* wb = dynamic_cast<const Weapon*>(b);
+        if (wa || wb) {
+            return wa && wb && wa->getBaseAtk() == wb->getBaseAtk() &&
+                   wa->getBaseCritRate() == wb->getBaseCritRate() &&
+                   wa->getBaseAtkSpeed() == wb->getBaseAtkSpeed() &&
+                   wa->getWeight() == wb->getWeight();
+        }
+        const Armor* aa = dynamic_cast<const Armor*>(a);
+        const Armor* ab = dynamic_cast<const Armor*>(b);
+        return aa && ab && aa->getBaseMaxHp() == ab->getBaseMaxHp() &&
+               aa->getBaseDodgeRate() == ab->getBaseDodgeRate() &&
+               aa->getBaseCapacity() == ab->getBaseCapacity();
+    }
+
     // 1. 初始化：加载所有游戏数据 (由队友设计的)
+    // 先做一次完整校验并报告所有问题，再只加载校验通过的条目
     static void initGameData(const string& dbFile) {
         ifstream f(dbFile);
         if (!f.is_open()) {
@@ -66,120 +374,415 @@ public:
             return;
         }
 
-        json j = json::parse(f);
-
-        // 加载装备模板
-        for (auto& item : j["equipments"]) {
-            int id = item["id"];
-            string type = item["type"];
-            string name = item["name"];
-            string fac = item["faction"];
-            Rarity rar = STANDARD;
-            if (item.contains("rarity")) {
-                string rarStr = item["rarity"];
-                if (rarStr == "BROKEN") rar = BROKEN;
-                else if (rarStr == "STANDARD") rar = STANDARD;
-                else if (rarStr == "MILITARY") rar = MILITARY;
-                else if (rarStr == "LEGENDARY") rar = LEGENDARY;
+        json j;
+        try {
+            j = json::parse(f);
+        } catch (json::parse_error& e) {
+            cout << "[JSON错误] 游戏数据解析失败: " << e.what() << endl;
+            return;
+        }
+
+        buildLibraryFromJson(j, itemLibrary, monsterLibrary);
+        cout << "[系统] 游戏数据库加载完毕，收录装备数: " << itemLibrary.size()
+             << "，怪物数: " << monsterLibrary.size() << endl;
+    }
+
+    // 从已解析的 JSON 构建模板库（只加载校验通过的条目）
+    static void buildLibraryFromJson(const json& j, map<int, Equipment*>& items, vector<Monster>& monsters) {
+        ValidationReport report = DataValidator::validate(j);
+        report.print(cout);
+
+        // 加载装备模板（创建模板对象存入 map，作为原型）
+        for (size_t i = 0; i < report.equipmentValid.size(); i++) {
+            if (!report.equipmentValid[i]) continue;
+            Equipment* eq = DataLoader::createEquipment(j["equipments"][i], 0);
+            items[eq->getId()] = eq;
+        }
+
+        // 加载怪物模板
+        monsters.clear();
+        for (size_t i = 0; i < report.monsterValid.size(); i++) {
+            if (!report.monsterValid[i]) continue;
+            monsters.push_back(DataLoader::createMonster(j["monsters"][i]));
+        }
+    }
+
+#ifdef EMBEDDED_CONTENT
+    // 从编译期内嵌表构建模板库（无文件 I/O、无解析）
+    static void buildLibraryFromEmbedded(map<int, Equipment*>& items, vector<Monster>& monsters) {
+        for (size_t i = 0; i < EMBEDDED_WEAPON_COUNT; i++) {
+            const EmbeddedWeapon& w = EMBEDDED_WEAPONS[i];
+            items[w.id] = new Weapon(w.id, w.name, w.rarity, 0, w.faction,
+                                     w.atk, w.critRate, w.atkSpeed, w.weight);
+        }
+        for (size_t i = 0; i < EMBEDDED_ARMOR_COUNT; i++) {
+            const EmbeddedArmor& a = EMBEDDED_ARMORS[i];
+            items[a.id] = new Armor(a.id, a.name, a.rarity, 0, a.faction,
+                                    a.hp, a.dodgeRate, a.capacity);
+        }
+        monsters.clear();
+        monsters.reserve(EMBEDDED_MONSTER_COUNT);
+        for (size_t i = 0; i < EMBEDDED_MONSTER_COUNT; i++) {
+            const EmbeddedMonster& m = EMBEDDED_MONSTERS[i];
+            monsters.push_back(Monster{m.id, m.name, m.hp, m.atk, m.exp});
+        }
+    }
+
+    // 1b. 初始化：使用内嵌内容表（展台/测试构建）
+    static void initEmbeddedGameData() {
+        buildLibraryFromEmbedded(itemLibrary, monsterLibrary);
+        cout << "[系统] 内嵌数据库加载完毕，收录装备数: " << itemLibrary.size()
+             << "，怪物数: " << monsterLibrary.size() << endl;
+    }
+
+    // 校验内嵌表与 JSON 运行时路径得到的模板完全一致
+    static bool verifyEmbeddedContent(const string& dbFile) {
+        ifstream f(dbFile);
+        if (!f.is_open()) {
+            cout << "[错误] 找不到游戏数据文件: " << dbFile << endl;
+            return false;
+        }
+        json j;
+        try {
+            j = json::parse(f);
+        } catch (json::parse_error& e) {
+            cout << "[JSON错误] 游戏数据解析失败: " << e.what() << endl;
+            return false;
+        }
+
+        map<int, Equipment*> jsonItems, embeddedItems;
+        vector<Monster> jsonMonsters, embeddedMonsters;
+        buildLibraryFromJson(j, jsonItems, jsonMonsters);
+        buildLibraryFromEmbedded(embeddedItems, embeddedMonsters);
+
+        int mismatches = 0;
+        if (jsonItems.size() != embeddedItems.size()) {
+            cout << "[校验] 装备数量不一致: JSON " << jsonItems.size()
+                 << " / 内嵌 " << embeddedItems.size() << endl;
+            mismatches++;
+        }
+        for (auto& pair : jsonItems) {
+            auto it = embeddedItems.find(pair.first);
+            if (it == embeddedItems.end() || !sameTemplate(pair.second, it->second)) {
+                cout << "[校验] 装备模板不一致: id " << pair.first << endl;
+                mismatches++;
             }
-            
-            // 创建模板对象存入 map，作为原型
-            if (type == "weapon") {
-                int atk = item["atk"];
-                int critRate = item.value("crit_rate", 0);  // 已经是*100后的值
-                int atkSpeed = item.value("atk_speed", 1);
-                int weight = item.value("weight", 1);
-                itemLibrary[id] = new Weapon(id, name, rar, 0, fac, atk, critRate, atkSpeed, weight);
-            } else if (type == "armor") {
-                int hp = item["hp"];
-                int dodgeRate = item.value("dodge_rate", 0);  // 已经是*100后的值
-                int capacity = item.value("capacity", 10);
-                itemLibrary[id] = new Armor(id, name, rar, 0, fac, hp, dodgeRate, capacity);
+        }
+
+        if (jsonMonsters.size() != embeddedMonsters.size()) {
+            cout << "[校验] 怪物数量不一致: JSON " << jsonMonsters.size()
+                 << " / 内嵌 " << embeddedMonsters.size() << endl;
+            mismatches++;
+        } else {
+            for (size_t i = 0; i < jsonMonsters.size(); i++) {
+                const Monster& a = jsonMonsters[i];
+                const Monster& b = embeddedMonsters[i];
+                if (a.id != b.id || a.name != b.name || a.hp != b.hp || a.atk != b.atk || a.exp != b.exp) {
+                    cout << "[校验] 怪物模板不一致: id " << a.id << endl;
+                    mismatches++;
+                }
             }
         }
-        cout << "[系统] 游戏数据库加载完毕，收录装备数: " << itemLibrary.size() << endl;
+
+        for (auto& pair : jsonItems) delete pair.second;
+        for (auto& pair : embeddedItems) delete pair.second;
+
+        if (mismatches == 0) {
+            cout << "[校验] 内嵌内容与 " << dbFile << " 完全一致。" << endl;
+        }
+        return mismatches == 0;
     }
+#endif
 
     // 2. 保存存档 (Serialization)
-    static void saveGame(int slotIndex, const string& playerName, const vector<Equipment*>& inventory, int playerExp, 
-                        Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons) {
+    // 背包以外的存档字段（与编码格式无关）；只读取不可变快照，可在存档线程中运行
+    static json buildSaveFields(const PlayerSnapshot& snap) {
         json saveJson;
-        saveJson["player_name"] = playerName;
-        saveJson["exp"] = playerExp;
+        saveJson["schema_version"] = SaveSchema::CURRENT_VERSION;
+        saveJson["player_name"] = snap.playerName;
+        saveJson["exp"] = snap.exp;
+
+        // 保存装备配置（armor_id 为 -1 表示未装备）
+        json equipConfig;
+        equipConfig["armor_id"] = snap.armorId;
+        equipConfig["weapon_ids"] = snap.weaponIds;
+        saveJson["equipment_config"] = equipConfig;
+
+        // 商店状态与玩家数据在同一个文件中，一次写入、一次读取
+        if (!snap.shops.is_null()) saveJson["shops"] = snap.shops;
+        return saveJson;
+    }
+
+    // 完整的存档 JSON（包括背包）；游戏内存档使用 SaveWriter 流式写出，不构建整个对象
+    static json buildSaveJson(const PlayerSnapshot& snap) {
+        json saveJson = buildSaveFields(snap);
         
         // 序列化背包
         json invArray = json::array();
-        for (auto item : inventory) {
+        snap.items.forEach([&invArray](const ItemRecord& item) {
             json itemJson;
-            itemJson["tid"] = item->getId(); // 只存ID
-            itemJson["lv"] = item->getLevel(); // 存当前等级
-            itemJson["rar"] = static_cast<int>(item->getRarity()); // 存当前稀有度
+            itemJson["tid"] = item.tid; // 只存ID
+            itemJson["lv"] = item.lv; // 存当前等级
+            itemJson["rar"] = item.rar; // 存当前稀有度
             invArray.push_back(itemJson);
-        }
+        });
         saveJson["inventory"] = invArray;
-        
-        // 保存装备配置
-        json equipConfig;
-        if (equippedArmor) {
-            equipConfig["armor_id"] = equippedArmor->getId();
-        } else {
-            equipConfig["armor_id"] = -1;  // -1 表示未装备
+        return saveJson;
+    }
+
+    static json buildSaveJson(const string& playerName, const vector<Equipment*>& inventory, int playerExp,
+                              Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons) {
+        PlayerSnapshot snap;
+        snap.playerName = playerName;
+        snap.exp = playerExp;
+        snap.armorId = equippedArmor ? equippedArmor->getId() : -1;
+        for (auto weapon : equippedWeapons) snap.weaponIds.push_back(weapon->getId());
+        snap.items.assign(inventory);
+        return buildSaveJson(snap);
+    }
+
+    // 2a. 手动存档 / 退出：提交完整快照（在后台写入），同时存入存档历史
+    // shops: 基地商店和篝火商店的状态 {"base_shop":...,"campfire_shop":...}
+    static void saveGame(const string& slotName, const string& playerName, const vector<Equipment*>& inventory, int playerExp, 
+                        Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons, const json& shops,
+                        const string& historyLabel = "手动存档") {
+        commitState(slotName, playerName, inventory, playerExp, equippedArmor, equippedWeapons, shops, true, historyLabel);
+        cout << "[存档] 游戏已保存至槽位 " << slotName << endl;
+    }
+
+    // 2c. 有风险的操作（可能失败的升级、装备合并）之前记录一个历史快照，之后可以回滚到这里
+    static void checkpoint(const string& slotName, const string& label, const string& playerName,
+                           const vector<Equipment*>& inventory, int playerExp, Equipment* equippedArmor,
+                           const vector<Equipment*>& equippedWeapons, const json& shops) {
+        commitState(slotName, playerName, inventory, playerExp, equippedArmor, equippedWeapons, shops, true, label);
+    }
+
+    // 2b. 自动存档：每次操作后调用，只把变化追加到日志
+    // 变化无法用日志表达、日志过长或距上次快照超过 AUTOSAVE_INTERVAL 秒时改写完整快照
+    static void recordChanges(const string& slotName, const string& playerName, const vector<Equipment*>& inventory,
+                              int playerExp, Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons,
+                              const json& shops) {
+        commitState(slotName, playerName, inventory, playerExp, equippedArmor, equippedWeapons, shops, false);
+    }
+
+    // 界面操作报告背包变化，下次保存时只比较这些位置（见 SaveJournal）
+    // 移除背包第 idx 件装备之前调用
+    static void noteItemRemoved(size_t idx) { journal.noteRemoved(idx); }
+    // 背包第 idx 件装备升级之后调用
+    static void noteItemLevelChanged(size_t idx) { journal.noteLevelChanged(idx); }
+    // 背包被整体替换或重排之后调用，下次保存完整比较
+    static void noteInventoryReplaced() { journal.noteUnknownChanges(); }
+
+    // 定时改写完整快照的间隔（秒）
+    static constexpr int AUTOSAVE_INTERVAL = 300;
+
+    // 界面线程只计算差异并生成快照（背包部分结构共享，与背包大小无关），
+    // 序列化和写盘交给存档线程
+    static void commitState(const string& slotName, const string& playerName, const vector<Equipment*>& inventory,
+                            int playerExp, Equipment* equippedArmor, const vector<Equipment*>& equippedWeapons,
+                            const json& shops, bool forceSnapshot, const string& historyLabel = "") {
+        vector<json> ops;
+        bool fresh = !journal.tracks(slotName);
+        bool incremental = !fresh &&
+            journal.record(playerName, inventory, playerExp, equippedArmor, equippedWeapons, shops, ops);
+        if (!incremental) {
+            journal.reset(slotName, fresh ? 0 : journal.getGeneration(), journal.getEntryCount(),
+                          playerName, inventory, playerExp, equippedArmor, equippedWeapons, shops);
         }
-        
-        json weaponIds = json::array();
-        for (auto weapon : equippedWeapons) {
-            weaponIds.push_back(weapon->getId());
+
+        bool pending = journal.getEntryCount() > 0 || !ops.empty();
+        bool periodic = pending && time(nullptr) - lastSnapshotTime >= AUTOSAVE_INTERVAL;
+        if (forceSnapshot || !incremental || saveFailed.exchange(false) ||
+            journal.needsCompaction() || periodic || rewriteSnapshot) {
+            rewriteSnapshot = false;
+            // 新快照使用新的日志代数，旧日志中的条目从此不再重放
+            journal.startGeneration();
+            lastSnapshotTime = time(nullptr);
+            submitSnapshot(slotName, journal.getGeneration(), journal.snapshot(), fresh, historyLabel);
+            return;
         }
-        equipConfig["weapon_ids"] = weaponIds;
-        saveJson["equipment_config"] = equipConfig;
+        if (ops.empty()) return;
 
-        // 写入文件到 saves 文件夹
-        string filename = "saves/save_slot_" + to_string(slotIndex) + ".json";
-        ofstream f(filename);
-        f << saveJson.dump(4); // 缩进4空格，美观
-        cout << "[存档] 游戏已保存至槽位 " << slotIndex << endl;
+        string lines = journal.stamp(ops);
+        const PlayerSnapshot& snap = journal.snapshot();
+        string name = snap.playerName;
+        int exp = snap.exp;
+        size_t itemCount = snap.items.size();
+        SaveFormat format = slotFormat;
+        SaveWorker::submit([slotName, lines, name, exp, itemCount, format]() {
+            if (!SaveIO::appendLine(SaveJournal::journalPath(slotName), lines)) {
+                cout << "[警告] 存档日志写入失败，下次保存时改为完整保存。" << endl;
+                saveFailed = true;
+                return;
+            }
+            // 快照没变，只更新列表显示的信息
+            writeSlotMeta(slotName, name, exp, itemCount, format);
+        });
+    }
+
+    // 在存档线程中序列化并原子写入完整快照
+    // fresh: 本次运行第一次写该槽位，旧日志属于未知代数，先删除
+    // historyLabel 不为空时，写完后把这个快照存入存档历史
+    static void submitSnapshot(const string& slotName, int generation, const PlayerSnapshot& snap, bool fresh,
+                               const string& historyLabel) {
+        SaveFormat format = slotFormat;
+        SaveWorker::submit([slotName, generation, snap, fresh, format, historyLabel]() {
+            if (fresh) {
+                SaveIO::removeFile(SaveJournal::journalPath(slotName));
+            }
+            json fields = buildSaveFields(snap);
+            fields["journal_gen"] = generation;
+
+            // 逐件流式写出背包并原子替换：内存占用与背包大小无关，崩溃时保留完整的旧存档
+            string filename = slotFile(slotName);
+            size_t size;
+            uint32_t crc;
+            if (!SaveWriter::write(filename, fields, snap.items, format) ||
+                !Checksum::crc32cFile(filename, size, crc)) {
+                cout << "[错误] 存档写入失败，槽位 " << slotName << " 保持原样！" << endl;
+                saveFailed = true;
+                return;
+            }
+            // 新快照已包含之前日志中的所有变化和商店状态
+            SaveIO::removeFile(SaveJournal::journalPath(slotName));
+            SaveIO::removeFile(legacyShopFile(slotName));
+            slotMeta.setSnapshot(size, crc);
+            writeSlotMeta(slotName, snap.playerName, snap.exp, snap.items.size(), format);
+
+            if (!historyLabel.empty() &&
+                !SaveHistory::add(slotName, filename, historyLabel, snap.playerName, snap.exp,
+                                  snap.items.size(), format)) {
+                cout << "[警告] 存档历史记录失败（当前存档不受影响）。" << endl;
+            }
+        });
+    }
+
+    // 2d. 把槽位回滚到某个历史快照：重写存档文件并丢弃之后的日志，调用方随后重新 loadSave
+    static bool restoreHistory(const string& slotName, int historyId, string& error) {
+        bool ok = false;
+        SaveWorker::submit([slotName, historyId, &ok, &error]() {
+            SaveHistory::Entry entry;
+            string filename = slotFile(slotName);
+            if (!SaveHistory::find(slotName, historyId, entry)) {
+                error = "找不到历史记录 #" + to_string(historyId);
+                return;
+            }
+            if (!SaveHistory::restore(slotName, historyId, filename, error)) return;
+            // 日志属于回滚前的快照，不能再重放到历史快照上
+            SaveIO::removeFile(SaveJournal::journalPath(slotName));
+            SaveIO::removeFile(legacyShopFile(slotName));
+            slotMeta.setSnapshot(entry.size, entry.checksum);
+            writeSlotMeta(slotName, entry.playerName, entry.exp, entry.itemCount, entry.format);
+            ok = true;
+        });
+        SaveWorker::flush();
+        return ok;
     }
 
     // 3. 加载存档 (Deserialization)
-    static vector<Equipment*> loadSave(int slotIndex, string& playerName, int& playerExp, 
-                                       int& equippedArmorId, vector<int>& equippedWeaponIds) {
+    // 根据存档中的背包数组还原装备
+    static vector<Equipment*> buildInventory(const json& invArray) {
         vector<Equipment*> result;
-        string filename = "saves/save_slot_" + to_string(slotIndex) + ".json";
-        ifstream f(filename);
+        result.reserve(invArray.size());
+        for (auto& itemJson : invArray) {
+            int tid = itemJson["tid"];
+            int lv = itemJson["lv"];
+            int rar = itemJson["rar"];
 
-        if (!f.is_open()) {
-            cout << "[提示] 存档槽 " << slotIndex << " 为空，将开始新游戏。" << endl;
+            // [关键步骤] 查表 -> 克隆 -> 恢复状态
+            if (Equipment* prototype = getItemTemplate(tid)) {
+                // 我们调用 clone，并传入存档里的等级
+                Equipment* newItem = prototype->clone(prototype->getName(), lv);
+                // 这里可能需要扩展 setRarity 方法来恢复稀有度
+                result.push_back(newItem);
+            }
+        }
+        return result;
+    }
+
+    // 旧版存档的商店状态在单独的 shop_slot 文件中，读出后合并进存档
+    static json readLegacyShops(const string& slotName) {
+        string data;
+        if (!SaveIO::readFile(legacyShopFile(slotName), data)) return json();
+        json shops = json::parse(data, nullptr, false);
+        if (shops.is_discarded() || !shops.is_object()) {
+            cout << "[警告] 旧版商店存档损坏（JSON 解析失败），正在重新初始化。" << endl;
+            return json();
+        }
+        rewriteSnapshot = true;
+        cout << "[存档] 已将旧版商店存档合并到槽位 " << slotName << "。" << endl;
+        return shops;
+    }
+
+    // shops: 返回存档中的商店状态，没有时为 null
+    static vector<Equipment*> loadSave(const string& slotName, string& playerName, int& playerExp, 
+                                       int& equippedArmorId, vector<int>& equippedWeaponIds, json& shops) {
+        vector<Equipment*> result;
+        shops = json();
+        string filename = slotFile(slotName);
+        slotFormat = SaveFormat::JSON;  // 新存档默认使用 JSON 文本
+        SaveWorker::submit([]() { slotMeta = SlotMeta(); });
+
+        if (!SaveIO::fileExists(filename)) {
+            cout << "[提示] 存档槽 " << slotName << " 为空，将开始新游戏。" << endl;
             playerExp = 0;
             equippedArmorId = -1;
             equippedWeaponIds.clear();
             return result; // 返回空背包
         }
 
-        // 尝试解析 JSON，如果失败则视为损坏
-        json j;
-        try {
-            j = json::parse(f);
-            f.close();
-        } catch (json::parse_error& e) {
-            f.close();
-            cout << "[警告] 存档槽 " << slotIndex << " 损坏（JSON 解析失败），将开始新游戏。" << endl;
-            cout << "[详细] " << e.what() << endl;
-            playerExp = 0;
-            equippedArmorId = -1;
-            equippedWeaponIds.clear();
-            return result;
-        } catch (...) {
-            f.close();
-            cout << "[警告] 存档槽 " << slotIndex << " 读取失败，将开始新游戏。" << endl;
+        // 边解析边还原装备，不构建整个存档的 JSON 对象
+        // 无法解码则视为损坏（独立分段损坏时只丢弃该分段）
+        SaveReadResult save;
+        bool readOk = SaveReader::read(filename, save, [&result](int tid, int lv, int) {
+            // [关键步骤] 查表 -> 克隆 -> 恢复状态
+            if (Equipment* prototype = getItemTemplate(tid)) {
+                result.push_back(prototype->clone(prototype->getName(), lv));
+            }
+        });
+        json& j = save.fields;
+        const vector<string>& damaged = save.damaged;
+        bool shopsDamaged = find(damaged.begin(), damaged.end(), "shops") != damaged.end();
+        if (readOk) slotFormat = save.format;
+
+        // 旧版本存档先逐步升级到当前结构，下一次保存时以当前版本写回；当前版本直接读取
+        string migrationError;
+        if (readOk && !SaveSchema::isCurrent(j)) {
+            int fromVersion = SaveSchema::versionOf(j);
+            SaveSchema::Context context;
+            context.legacyShops = [&slotName, shopsDamaged]() {
+                return shopsDamaged ? json() : readLegacyShops(slotName);
+            };
+            vector<string> applied;
+            if (SaveSchema::migrate(j, context, applied, migrationError)) {
+                cout << "[存档] 存档结构已从版本 " << fromVersion << " 升级到版本 " << SaveSchema::CURRENT_VERSION;
+                if (!applied.empty()) {
+                    cout << "（";
+                    for (size_t i = 0; i < applied.size(); i++) cout << (i ? "、" : "") << applied[i];
+                    cout << "）";
+                }
+                cout << "，下次保存时写回。" << endl;
+                rewriteSnapshot = true;
+            } else {
+                readOk = false;
+                save.error = migrationError;
+            }
+        }
+        if (!readOk) {
+            for (auto item : result) delete item;
+            result.clear();
+            cout << "[警告] 存档槽 " << slotName << " 损坏（" << save.error << "），将开始新游戏。" << endl;
             playerExp = 0;
             equippedArmorId = -1;
             equippedWeaponIds.clear();
             return result;
         }
         
-        // 检查必要字段
-        if (!j.contains("player_name") || !j.contains("inventory")) {
-            cout << "[警告] 存档槽 " << slotIndex << " 损坏（缺少必要字段），将开始新游戏。" << endl;
+        // 检查必要字段（当前结构中全部字段都必定存在）
+        if (!SaveSchema::isComplete(j)) {
+            for (auto item : result) delete item;
+            result.clear();
+            cout << "[警告] 存档槽 " << slotName << " 损坏（缺少必要字段），将开始新游戏。" << endl;
             playerExp = 0;
             equippedArmorId = -1;
             equippedWeaponIds.clear();
@@ -187,160 +790,241 @@ public:
         }
         
         playerName = j["player_name"];
-        playerExp = j.value("exp", 0);  // 读取exp，默认为0
+        playerExp = j["exp"];
+        
+        // 加载装备配置
+        const json& equipConfig = j["equipment_config"];
+        equippedArmorId = equipConfig["armor_id"];
+        equippedWeaponIds = equipConfig["weapon_ids"].get<vector<int>>();
 
-        for (auto& itemJson : j["inventory"]) {
-            int tid = itemJson["tid"];
-            int lv = itemJson["lv"];
-            int rar = itemJson["rar"];
+        // 商店状态与玩家数据保存在同一个文件中
+        if (shopsDamaged) {
+            cout << "[警告] 存档槽 " << slotName << " 的商店数据校验失败，商店将重新初始化（玩家数据不受影响）。" << endl;
+        } else if (j.contains("shops")) {
+            shops = j["shops"];
+        }
+        // 丢弃了损坏的分段，下一次保存写入完整快照修复存档文件
+        if (!damaged.empty()) rewriteSnapshot = true;
 
-            // [关键步骤] 查表 -> 克隆 -> 恢复状态
-            if (itemLibrary.count(tid)) {
-                Equipment* prototype = itemLibrary[tid];
-                // 我们调用 clone，并传入存档里的等级
-                Equipment* newItem = prototype->clone(prototype->getName(), lv);
-                // 这里可能需要扩展 setRarity 方法来恢复稀有度
-                result.push_back(newItem);
+        // 重放快照之后追加到日志中的变更
+        int generation = j.value("journal_gen", 0);
+        bool intact = true;
+        vector<json> entries = SaveJournal::readEntries(slotName, generation, intact);
+        size_t applied = 0;
+        for (; applied < entries.size(); applied++) {
+            if (!applyJournalEntry(entries[applied], result, playerExp, equippedArmorId, equippedWeaponIds, shops)) {
+                cout << "[警告] 存档日志第 " << applied + 1 << " 条无法应用，之后的变更已忽略。" << endl;
+                break;
             }
         }
-        
-        // 加载装备配置
-        equippedArmorId = -1;
-        equippedWeaponIds.clear();
-        if (j.contains("equipment_config")) {
-            json equipConfig = j["equipment_config"];
-            equippedArmorId = equipConfig.value("armor_id", -1);
-            
-            if (equipConfig.contains("weapon_ids")) {
-                for (auto& weaponId : equipConfig["weapon_ids"]) {
-                    equippedWeaponIds.push_back(weaponId);
-                }
-            }
+        if (!intact || applied < entries.size()) {
+            // 去掉残缺或无法应用的条目，之后的追加才能被正确读取
+            entries.resize(applied);
+            SaveJournal::rewrite(slotName, entries);
         }
+        if (applied > 0) {
+            cout << "[存档] 已从日志恢复 " << applied << " 项变更。" << endl;
+        }
+        resetJournal(slotName, generation, applied, playerName, result, playerExp,
+                     equippedArmorId, equippedWeaponIds, shops);
+
+        lastSnapshotTime = time(nullptr);
+
+        // 元数据与快照不一致（旧存档或文件被手动修改）时重建；元数据只在存档线程中访问
+        SlotMeta meta;
+        bool stale = !SlotMeta::read(slotName, meta) || !meta.matchesSnapshot(save.fileSize, save.fileCrc);
+        if (stale) meta = metaFromSnapshot(save);
+        SaveFormat format = slotFormat;
+        size_t itemCount = result.size();
+        SaveWorker::submit([slotName, meta, stale, playerName, playerExp, itemCount, format]() {
+            slotMeta = meta;
+            if (stale) writeSlotMeta(slotName, playerName, playerExp, itemCount, format);
+        });
         
-        cout << "[存档] 读取存档槽 " << slotIndex << " 成功！" << endl;
+        cout << "[存档] 读取存档槽 " << slotName << " 成功！" << endl;
         return result;
     }
     
-    // 4. 初始化所有存档槽位
+    // 4. 初始化存档文件夹和默认槽位 1-3（其他槽位按名字创建）
     static void initializeSaveSlots() {
         // 首先确保 saves 文件夹存在
         ensureSavesFolderExists();
         
         for (int i = 1; i <= 3; i++) {
-            string filename = "saves/save_slot_" + to_string(i) + ".json";
-            bool needsCreation = false;
-            
-            // 尝试打开并解析存档文件
-            ifstream checkFile(filename);
-            if (!checkFile.is_open()) {
-                // 文件不存在
-                needsCreation = true;
-                cout << "[系统] 存档槽 " << i << " 不存在，正在创建..." << endl;
-            } else {
-                // 文件存在，检查是否损坏
-                try {
-                    json j = json::parse(checkFile);
-                    checkFile.close();
-                    
-                    // 检查必要字段是否存在
-                    if (!j.contains("player_name") || !j.contains("exp") || !j.contains("inventory")) {
-                        cout << "[警告] 存档槽 " << i << " 损坏（缺少必要字段），正在重建..." << endl;
-                        needsCreation = true;
-                    }
-                } catch (json::parse_error& e) {
-                    // JSON 解析失败，文件损坏
-                    cout << "[警告] 存档槽 " << i << " 损坏（JSON 解析失败），正在重建..." << endl;
-                    checkFile.close();
-                    needsCreation = true;
-                } catch (...) {
-                    // 其他异常
-                    cout << "[警告] 存档槽 " << i << " 读取失败，正在重建..." << endl;
-                    checkFile.close();
-                    needsCreation = true;
-                }
+            string slotName = to_string(i);
+            if (!SaveIO::fileExists(slotFile(slotName))) {
+                cout << "[系统] 存档槽 " << slotName << " 不存在，正在创建..." << endl;
+                createEmptySlot(slotName);
             }
-            
-            // 如果需要创建或重建，创建空存档
-            if (needsCreation) {
-                json emptySlot;
-                emptySlot["player_name"] = "";
-                emptySlot["exp"] = 0;
-                emptySlot["inventory"] = json::array();
-                emptySlot["equipment_config"] = {
-                    {"armor_id", -1},
-                    {"weapon_ids", json::array()}
-                };
-                
-                ofstream f(filename);
-                if (f.is_open()) {
-                    f << emptySlot.dump(4);
-                    f.close();
-                    cout << "[系统] 存档槽 " << i << " 已创建。" << endl;
-                } else {
-                    cout << "[错误] 无法创建存档槽 " << i << "！" << endl;
-                }
+        }
+    }
+
+    // 4b. 选中槽位后检查存档是否完好，损坏时重建为空存档
+    // 与元数据记录的大小和校验和一致即视为完好，无需解析
+    static void prepareSlot(const string& slotName) {
+        string filename = slotFile(slotName);
+        bool needsCreation = false;
+
+        // 上次写入中途崩溃留下的临时文件，原存档未受影响
+        SaveIO::removeFile(filename + ".tmp");
+        
+        SaveReadResult save;
+        SlotMeta meta;
+        if (!SaveIO::fileExists(filename)) {
+            // 文件不存在
+            needsCreation = true;
+            cout << "[系统] 存档槽 " << slotName << " 不存在，正在创建..." << endl;
+        } else if (SlotMeta::read(slotName, meta) && meta.matchesFile(filename)) {
+            return;
+        } else if (!scanSnapshot(slotName, save)) {
+            // 解码失败，文件损坏
+            cout << "[警告] 存档槽 " << slotName << " 损坏（" << save.error << "），正在重建..." << endl;
+            needsCreation = true;
+        } else if (!checkSchema(save.fields)) {
+            // 检查必要字段是否存在（旧版本存档先在内存中迁移，缺少的字段由迁移补全）
+            cout << "[警告] 存档槽 " << slotName << " 损坏（缺少必要字段），正在重建..." << endl;
+            needsCreation = true;
+        } else {
+            // 玩家数据完好但没有元数据（旧版本存档）或被手动修改过：补写元数据
+            // 独立分段（商店）的损坏在读档时单独处理，不必重建整个槽位
+            metaFromSnapshot(save).write(slotName);
+        }
+        
+        // 如果需要创建或重建，创建空存档
+        if (needsCreation) {
+            createEmptySlot(slotName);
+            size_t historyCount = SaveHistory::list(slotName).size();
+            if (historyCount > 0) {
+                cout << "[提示] 该槽位有 " << historyCount << " 条存档历史，进入游戏后可在 [9] 存档历史 中回滚。" << endl;
             }
         }
     }
-    
-    // 5. 检查存档槽位是否为空
-    static bool isSlotEmpty(int slotIndex) {
-        string filename = "saves/save_slot_" + to_string(slotIndex) + ".json";
-        ifstream f(filename);
+
+    static void createEmptySlot(const string& slotName) {
+        json emptySlot;
+        emptySlot["schema_version"] = SaveSchema::CURRENT_VERSION;
+        emptySlot["player_name"] = "";
+        emptySlot["exp"] = 0;
+        emptySlot["inventory"] = json::array();
+        emptySlot["equipment_config"] = {
+            {"armor_id", -1},
+            {"weapon_ids", json::array()}
+        };
         
-        if (!f.is_open()) {
+        string emptyData = emptySlot.dump(4);
+        if (SaveIO::atomicWrite(slotFile(slotName), emptyData)) {
+            // 没有有效快照时，残留的日志也无法应用
+            SaveIO::removeFile(SaveJournal::journalPath(slotName));
+            SlotMeta meta;
+            meta.setSnapshot(emptyData);
+            meta.write(slotName);
+            cout << "[系统] 存档槽 " << slotName << " 已创建。" << endl;
+        } else {
+            cout << "[错误] 无法创建存档槽 " << slotName << "！" << endl;
+        }
+    }
+
+    // 槽位名会成为文件名的一部分，只允许英文字母、数字、下划线和减号
+    static bool isValidSlotName(const string& slotName) {
+        if (slotName.empty() || slotName.size() > MAX_SLOT_NAME_LENGTH) return false;
+        for (char c : slotName) {
+            if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') return false;
+        }
+        return true;
+    }
+
+    // 扫描 saves 文件夹中的所有槽位（save_slot_<名字>.json），数字名按数值排在前面
+    static vector<string> listSlots() {
+        static const string prefix = "save_slot_";
+        static const string suffix = ".json";
+        vector<string> slots;
+        error_code ec;
+        for (filesystem::directory_iterator it("saves", ec), end; !ec && it != end; it.increment(ec)) {
+            string file = it->path().filename().string();
+            if (file.size() <= prefix.size() + suffix.size() ||
+                file.compare(0, prefix.size(), prefix) != 0 ||
+                file.compare(file.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            string slotName = file.substr(prefix.size(), file.size() - prefix.size() - suffix.size());
+            if (isValidSlotName(slotName)) slots.push_back(slotName);
+        }
+
+        auto isNumber = [](const string& name) {
+            return all_of(name.begin(), name.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); });
+        };
+        sort(slots.begin(), slots.end(), [&isNumber](const string& a, const string& b) {
+            bool na = isNumber(a), nb = isNumber(b);
+            if (na != nb) return na;
+            if (na && a.size() != b.size()) return a.size() < b.size();  // 数字名按数值排序
+            return a < b;
+        });
+        return slots;
+    }
+
+    // 5. 检查存档槽位是否为空
+    static bool isSlotEmpty(const string& slotName) {
+        SlotMeta meta;
+        if (!readSlotMeta(slotName, meta)) {
             return true;
         }
         
-        try {
-            json j = json::parse(f);
-            f.close();
-            
-            // 检查玩家名字是否为空
-            string playerName = j.value("player_name", "");
-            return playerName.empty();
-        } catch (json::parse_error& e) {
-            // 文件损坏，视为空存档
-            f.close();
-            cout << "[警告] 存档槽 " << slotIndex << " 损坏，视为空存档。" << endl;
-            return true;
-        } catch (...) {
-            f.close();
+        // 检查玩家名字是否为空
+        return meta.playerName.empty();
+    }
+
+    // 读取槽位元数据；没有元数据时解析一次快照并补写
+    // 快照不存在或已损坏时返回 false
+    static bool readSlotMeta(const string& slotName, SlotMeta& meta) {
+        if (SlotMeta::read(slotName, meta)) {
             return true;
         }
+        if (!SaveIO::fileExists(slotFile(slotName))) {
+            return false;
+        }
+        SaveReadResult save;
+        if (!scanSnapshot(slotName, save)) {
+            // 文件损坏，视为空存档
+            cout << "[警告] 存档槽 " << slotName << " 损坏，视为空存档。" << endl;
+            return false;
+        }
+        meta = metaFromSnapshot(save);
+        meta.write(slotName);
+        return true;
     }
     
-    // 6. 显示所有存档槽位信息
-    static void showSaveSlots() {
-        cout << "\n=== 存档槽位 ===" << endl;
-        for (int i = 1; i <= 3; i++) {
-            cout << "[" << i << "] 存档 " << i << " - ";
+    // 6. 分页显示存档槽位信息（只读取当前页每个槽位的元数据，与槽位总数和背包大小无关）
+    static void showSaveSlots(const vector<string>& slots, int page) {
+        int pageCount = max(1, static_cast<int>((slots.size() + SLOT_PAGE_SIZE - 1) / SLOT_PAGE_SIZE));
+        cout << "\n=== 存档槽位 (第 " << page + 1 << "/" << pageCount << " 页，共 " << slots.size() << " 个) ===" << endl;
+        size_t first = static_cast<size_t>(page) * SLOT_PAGE_SIZE;
+        for (size_t i = first; i < slots.size() && i < first + SLOT_PAGE_SIZE; i++) {
+            const string& slotName = slots[i];
+            cout << "[" << slotName << "] 存档 " << slotName << " - ";
             
-            if (isSlotEmpty(i)) {
+            SlotMeta meta;
+            if (!readSlotMeta(slotName, meta) || meta.playerName.empty()) {
                 cout << "空槽位" << endl;
-            } else {
-                try {
-                    string filename = "saves/save_slot_" + to_string(i) + ".json";
-                    ifstream f(filename);
-                    json j = json::parse(f);
-                    f.close();
-                    
-                    string playerName = j.value("player_name", "未知");
-                    int exp = j.value("exp", 0);
-                    int itemCount = j.contains("inventory") ? j["inventory"].size() : 0;
-                    
-                    cout << playerName << " (EXP: " << exp << ", 装备: " << itemCount << "件)" << endl;
-                } catch (json::parse_error& e) {
-                    cout << "损坏的存档（将在选择后自动修复）" << endl;
-                } catch (...) {
-                    cout << "无法读取（将在选择后自动修复）" << endl;
-                }
+                continue;
             }
+            cout << meta.playerName << " (EXP: " << meta.exp << ", 装备: " << meta.itemCount << "件)";
+            string savedAt = meta.savedAtText();
+            if (!savedAt.empty()) cout << " " << savedAt;
+            if (meta.format == SaveFormat::MSGPACK) cout << " [二进制]";
+            cout << endl;
         }
         cout << "===================" << endl;
     }
     
+    // 当前槽位的存档格式；修改后下一次完整保存生效
+    static SaveFormat getSlotFormat() {
+        return slotFormat;
+    }
+
+    static void setSlotFormat(SaveFormat format) {
+        slotFormat = format;
+    }
+
     // 静态成员变量需要在类外初始化
     static void cleanUp() {
         for(auto& pair : itemLibrary) delete pair.second;
@@ -351,5 +1035,11 @@ public:
 // 静态成员初始化
 map<int, Equipment*> SaveManager::itemLibrary;
 vector<Monster> SaveManager::monsterLibrary;
+SaveJournal SaveManager::journal;
+SaveFormat SaveManager::slotFormat = SaveFormat::JSON;
+SlotMeta SaveManager::slotMeta;
+atomic<bool> SaveManager::saveFailed(false);
+time_t SaveManager::lastSnapshotTime = 0;
+bool SaveManager::rewriteSnapshot = false;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ * 文件名: SaveSchema.h
+ * 职责: 存档结构版本 - 读到旧版本存档时按顺序执行已注册的迁移步骤，升级到当前结构
+ *
+ * 存档字段 "schema_version" 记录结构版本，没有该字段的存档视为版本 0。
+ * 每个迁移步骤把版本 N 的字段改写为版本 N+1；当前版本的存档不经过任何迁移代码，
+ * 读档代码只按当前结构读取，不再到处用默认值兜底。升级后的存档在下一次保存时以当前版本写回。
+ *
+ * 版本历史:
+ *   0  exp、equipment_config 可能不存在；商店状态保存在单独的 saves/shop_slot_<槽位名>.json
+ *   1  exp、equipment_config 必定存在（armor_id 为 -1 表示未装备）
+ *   2  商店状态在存档的 shops 字段中（字段不存在表示还没有商店状态）
+ * 背包中每件装备的 {"tid","lv","rar"} 从版本 0 起没有变化（rar 只作记录，读档时稀有度取自模板）。
+ * 迁移只处理背包以外的字段：流式读档时背包不在 json 中，而是逐件交给回调。
+ */
+
+#ifndef SAVE_SCHEMA_H
+#define SAVE_SCHEMA_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+class SaveSchema {
+public:
+    static constexpr int CURRENT_VERSION = 2;
+
+    // 迁移步骤需要的存档以外的信息
+    struct Context {
+        // 读取旧版单独保存的商店状态；没有时返回 null（不设置表示不读取，例如启动检查）
+        function<json()> legacyShops;
+    };
+
+    // 把版本 from 的存档字段改写为版本 from + 1；无法迁移时返回 false 并填写 error
+    using Step = function<bool(json& fields, const Context& context, string& error)>;
+
+    struct Migration {
+        int from;
+        string description;
+        Step apply;
+    };
+
+    static int versionOf(const json& fields) {
+        auto it = fields.find("schema_version");
+        return it != fields.end() && it->is_number_integer() ? it->get<int>() : 0;
+    }
+
+    static bool isCurrent(const json& fields) {
+        return versionOf(fields) == CURRENT_VERSION;
+    }
+
+    // 注册迁移步骤；同一个起始版本只能有一个步骤
+    static bool registerMigration(int from, const string& description, Step apply) {
+        for (const Migration& m : migrations()) {
+            if (m.from == from) return false;
+        }
+        migrations().push_back({from, description, move(apply)});
+        return true;
+    }
+
+    // 依次执行迁移直到当前版本；applied 返回执行过的步骤说明
+    static bool migrate(json& fields, const Context& context, vector<string>& applied, string& error) {
+        int version = versionOf(fields);
+        if (version > CURRENT_VERSION) {
+            error = "存档结构版本 " + to_string(version) + " 高于程序支持的版本 " + to_string(CURRENT_VERSION);
+            return false;
+        }
+        while (version < CURRENT_VERSION) {
+            const Migration* step = nullptr;
+            for (const Migration& m : migrations()) {
+                if (m.from == version) step = &m;
+            }
+            if (!step) {
+                error = "缺少从版本 " + to_string(version) + " 升级的迁移步骤";
+                return false;
+            }
+            if (!step->apply(fields, context, error)) return false;
+            applied.push_back(step->description);
+            fields["schema_version"] = ++version;
+        }
+        return true;
+    }
+
+    // 当前版本的必需字段齐全且类型正确
+    static bool isComplete(const json& fields) {
+        if (!fields.contains("player_name") || !fields["player_name"].is_string()) return false;
+        if (!fields.contains("exp") || !fields["exp"].is_number_integer()) return false;
+        if (!fields.contains("inventory")) return false;
+        if (!fields.contains("equipment_config") || !fields["equipment_config"].is_object()) return false;
+        const json& config = fields["equipment_config"];
+        if (!config.contains("armor_id") || !config["armor_id"].is_number_integer()) return false;
+        if (!config.contains("weapon_ids") || !config["weapon_ids"].is_array()) return false;
+        for (const json& id : config["weapon_ids"]) {
+            if (!id.is_number_integer()) return false;
+        }
+        return !fields.contains("shops") || fields["shops"].is_object();
+    }
+
+private:
+    // 已注册的迁移步骤；内置步骤在第一次使用时注册
+    static vector<Migration>& migrations() {
+        static vector<Migration> list = builtinMigrations();
+        return list;
+    }
+
+    static vector<Migration> builtinMigrations() {
+        vector<Migration> list;
+
+        // 0 -> 1: 最早的存档可能没有 exp 和装备配置
+        list.push_back({0, "补全 EXP 和装备配置", [](json& fields, const Context&, string& error) {
+            if (!fields.contains("exp")) fields["exp"] = 0;
+            if (!fields.contains("equipment_config") || !fields["equipment_config"].is_object()) {
+                fields["equipment_config"] = json::object();
+            }
+            json& config = fields["equipment_config"];
+            if (!config.contains("armor_id")) config["armor_id"] = -1;
+            if (!config.contains("weapon_ids")) config["weapon_ids"] = json::array();
+            if (!fields["exp"].is_number_integer() || !config["armor_id"].is_number_integer() ||
+                !config["weapon_ids"].is_array()) {
+                error = "exp 或装备配置的类型错误";
+                return false;
+            }
+            return true;
+        }});
+
+        // 1 -> 2: 把单独保存的商店状态合并进存档
+        list.push_back({1, "合并旧版商店存档", [](json& fields, const Context& context, string&) {
+            if (!fields.contains("shops") && context.legacyShops) {
+                json shops = context.legacyShops();
+                if (shops.is_object()) fields["shops"] = shops;
+            }
+            return true;
+        }});
+
+        return list;
+    }
+};
+
+#endif // SAVE_SCHEMA_H
@@ -0,0 +1,144 @@
+/**
+ * 文件名: SaveSnapshot.h
+ * 职责: 存档快照 - 可在线程间共享的不可变玩家状态（写时复制）
+ *
+ * 背包按块存放装备记录，每块最多 CHUNK_SIZE 条，块一旦创建就不再修改。
+ * 复制 InventoryImage 只复制一个指向块列表的指针（O(1)）；之后修改某一条时
+ * 只复制它所在的块，以及（有快照共享时）块指针列表，其余块由新旧快照共用。
+ * 后台存档线程拿到的快照不会再被修改，因此无需加锁。
+ */
+
+#ifndef SAVE_SNAPSHOT_H
+#define SAVE_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include "GameCore.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 背包中一件装备的存档状态
+struct ItemRecord {
+    const Equipment* ptr;  // 只用于识别同一件装备，后台线程不会解引用
+    int tid;
+    int lv;
+    int rar;
+};
+
+class InventoryImage {
+public:
+    static constexpr size_t CHUNK_SIZE = 64;
+    using Chunk = vector<ItemRecord>;
+    using ChunkList = vector<shared_ptr<const Chunk>>;
+
+private:
+    shared_ptr<ChunkList> chunks = make_shared<ChunkList>();
+    size_t count = 0;
+
+    // 块指针列表被快照共享时先复制一份（只复制指针）
+    ChunkList& mutableList() {
+        if (chunks.use_count() > 1) {
+            chunks = make_shared<ChunkList>(*chunks);
+        }
+        return *chunks;
+    }
+
+    // 第 idx 条记录所在的块和块内位置
+    pair<size_t, size_t> locate(size_t idx) const {
+        size_t c = 0;
+        while (idx >= (*chunks)[c]->size()) {
+            idx -= (*chunks)[c]->size();
+            c++;
+        }
+        return {c, idx};
+    }
+
+public:
+    static ItemRecord recordOf(const Equipment* eq) {
+        return {eq, eq->getId(), eq->getLevel(), static_cast<int>(eq->getRarity())};
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // 整体重建（改名、背包重排等无法增量表达的变化）
+    void assign(const vector<Equipment*>& inventory) {
+        auto list = make_shared<ChunkList>();
+        for (size_t i = 0; i < inventory.size(); i += CHUNK_SIZE) {
+            auto chunk = make_shared<Chunk>();
+            chunk->reserve(CHUNK_SIZE);
+            for (size_t k = i; k < inventory.size() && k < i + CHUNK_SIZE; k++) {
+                chunk->push_back(recordOf(inventory[k]));
+            }
+            list->push_back(chunk);
+        }
+        chunks = list;
+        count = inventory.size();
+    }
+
+    void push(const ItemRecord& record) {
+        ChunkList& list = mutableList();
+        if (list.empty() || list.back()->size() >= CHUNK_SIZE) {
+            auto chunk = make_shared<Chunk>();
+            chunk->reserve(CHUNK_SIZE);
+            chunk->push_back(record);
+            list.push_back(chunk);
+        } else {
+            auto chunk = make_shared<Chunk>(*list.back());
+            chunk->push_back(record);
+            list.back() = chunk;
+        }
+        count++;
+    }
+
+    const ItemRecord& at(size_t idx) const {
+        auto pos = locate(idx);
+        return (*(*chunks)[pos.first])[pos.second];
+    }
+
+    void remove(size_t idx) {
+        auto pos = locate(idx);
+        ChunkList& list = mutableList();
+        if (list[pos.first]->size() == 1) {
+            list.erase(list.begin() + pos.first);
+        } else {
+            auto chunk = make_shared<Chunk>(*list[pos.first]);
+            chunk->erase(chunk->begin() + pos.second);
+            list[pos.first] = chunk;
+        }
+        count--;
+    }
+
+    void setLevel(size_t idx, int lv) {
+        auto pos = locate(idx);
+        ChunkList& list = mutableList();
+        auto chunk = make_shared<Chunk>(*list[pos.first]);
+        (*chunk)[pos.second].lv = lv;
+        list[pos.first] = chunk;
+    }
+
+    // 按背包顺序遍历所有记录
+    template <typename Func>
+    void forEach(Func func) const {
+        for (auto& chunk : *chunks) {
+            for (const ItemRecord& record : *chunk) func(record);
+        }
+    }
+};
+
+// 一次保存所需的全部玩家状态；复制代价与背包大小无关
+struct PlayerSnapshot {
+    string playerName;
+    int exp = 0;
+    int armorId = -1;        // -1 表示未装备
+    vector<int> weaponIds;
+    InventoryImage items;
+    json shops;              // 基地商店和篝火商店的状态（很小，直接复制）
+};
+
+#endif // SAVE_SNAPSHOT_H
@@ -0,0 +1,558 @@
+/**
+ * 文件名: SaveStream.h
+ * 职责: 流式存档读写 - 不构建整个存档的 JSON 对象，内存占用与背包大小无关
+ *
+ * SaveWriter 从 PlayerSnapshot 的背包中逐件写出装备，经小缓冲区直接写入临时文件后原子替换；
+ * SaveReader 以 SAX 方式边解析边回调每件装备，背包以外的小字段（装备配置、商店等）仍组装成 json。
+ * 文件布局与 SaveCodec 完全相同（JSON 缩进文本 / 带分段的 MessagePack），两者写出的存档可以互相读取。
+ */
+
+#ifndef SAVE_STREAM_H
+#define SAVE_STREAM_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <streambuf>
+#include <cstdio>
+#include <cstdint>
+#include "json.hpp"
+#include "SaveIO.h"
+#include "SaveFormat.h"
+#include "SaveSnapshot.h"
+#include "Checksum.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 流式写出存档
+class SaveWriter {
+private:
+    // 攒够一小段再写入文件，同时统计当前分段的字节数和校验和
+    class Sink {
+    private:
+        SaveIO::AtomicFile& file;
+        string buffer;
+        uint32_t crc = 0;
+        size_t count = 0;
+
+    public:
+        static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+        explicit Sink(SaveIO::AtomicFile& target) : file(target) {}
+
+        void put(const char* p, size_t n) {
+            crc = Checksum::crc32c(p, n, crc);
+            count += n;
+            buffer.append(p, n);
+            if (buffer.size() >= FLUSH_SIZE) flush();
+        }
+
+        void put(const string& s) {
+            put(s.data(), s.size());
+        }
+
+        void put(char c) {
+            put(&c, 1);
+        }
+
+        void flush() {
+            file.write(buffer);
+            buffer.clear();
+        }
+
+        // 开始统计新的分段
+        void restart() {
+            flush();
+            crc = 0;
+            count = 0;
+        }
+
+        uint32_t checksum() const {
+            return crc;
+        }
+
+        size_t size() const {
+            return count;
+        }
+    };
+
+    // ---- MessagePack 编码（与 json::to_msgpack 对相同数据的输出一致）----
+    static void putBigEndian(Sink& out, uint8_t tag, uint64_t v, int bytes) {
+        char buf[9];
+        buf[0] = static_cast<char>(tag);
+        for (int i = 0; i < bytes; i++) buf[1 + i] = static_cast<char>((v >> (8 * (bytes - 1 - i))) & 0xFF);
+        out.put(buf, 1 + bytes);
+    }
+
+    static void putInt(Sink& out, int64_t v) {
+        if (v >= 0) {
+            if (v < 128) out.put(static_cast<char>(v));
+            else if (v <= 0xFF) putBigEndian(out, 0xCC, v, 1);
+            else if (v <= 0xFFFF) putBigEndian(out, 0xCD, v, 2);
+            else if (v <= 0xFFFFFFFFLL) putBigEndian(out, 0xCE, v, 4);
+            else putBigEndian(out, 0xCF, v, 8);
+        } else {
+            if (v >= -32) out.put(static_cast<char>(v));
+            else if (v >= INT8_MIN) putBigEndian(out, 0xD0, static_cast<uint64_t>(v), 1);
+            else if (v >= INT16_MIN) putBigEndian(out, 0xD1, static_cast<uint64_t>(v), 2);
+            else if (v >= INT32_MIN) putBigEndian(out, 0xD2, static_cast<uint64_t>(v), 4);
+            else putBigEndian(out, 0xD3, static_cast<uint64_t>(v), 8);
+        }
+    }
+
+    static void putStr(Sink& out, const string& s) {
+        size_t n = s.size();
+        if (n <= 31) out.put(static_cast<char>(0xA0 | n));
+        else if (n <= 0xFF) putBigEndian(out, 0xD9, n, 1);
+        else if (n <= 0xFFFF) putBigEndian(out, 0xDA, n, 2);
+        else putBigEndian(out, 0xDB, n, 4);
+        out.put(s);
+    }
+
+    static void putContainer(Sink& out, uint8_t fixTag, uint8_t tag16, size_t n) {
+        if (n <= 15) out.put(static_cast<char>(fixTag | n));
+        else if (n <= 0xFFFF) putBigEndian(out, tag16, n, 2);
+        else putBigEndian(out, tag16 + 1, n, 4);
+    }
+
+    static void putInventoryMsgpack(Sink& out, const InventoryImage& items) {
+        putContainer(out, 0x90, 0xDC, items.size());
+        items.forEach([&out](const ItemRecord& item) {
+            putContainer(out, 0x80, 0xDE, 3);
+            putStr(out, "lv");
+            putInt(out, item.lv);
+            putStr(out, "rar");
+            putInt(out, item.rar);
+            putStr(out, "tid");
+            putInt(out, item.tid);
+        });
+    }
+
+    // ---- JSON 文本（与 dump(4) 的输出一致）----
+    // 顶层字段的值缩进一级
+    static string indented(const json& value) {
+        string text = value.dump(4);
+        string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            out += c;
+            if (c == '\n') out += "    ";
+        }
+        return out;
+    }
+
+    static void putInventoryJson(Sink& out, const InventoryImage& items) {
+        if (items.size() == 0) {
+            out.put("[]");
+            return;
+        }
+        out.put("[\n");
+        size_t index = 0;
+        items.forEach([&out, &index](const ItemRecord& item) {
+            if (index++ > 0) out.put(",\n");
+            out.put("        {\n            \"lv\": " + to_string(item.lv) +
+                    ",\n            \"rar\": " + to_string(item.rar) +
+                    ",\n            \"tid\": " + to_string(item.tid) + "\n        }");
+        });
+        out.put("\n    ]");
+    }
+
+    static bool writeJson(SaveIO::AtomicFile& file, const json& fields, const InventoryImage& items) {
+        Sink out(file);
+        json sectionCrc = SaveCodec::sectionChecksums(fields);
+        vector<string> keys;
+        for (auto& field : fields.items()) keys.push_back(field.key());
+        keys.push_back("inventory");
+        if (!sectionCrc.is_null()) keys.push_back("section_crc");
+        sort(keys.begin(), keys.end());
+
+        out.put("{\n");
+        for (size_t i = 0; i < keys.size(); i++) {
+            out.put("    " + json(keys[i]).dump() + ": ");
+            if (keys[i] == "inventory") putInventoryJson(out, items);
+            else if (keys[i] == "section_crc") out.put(indented(sectionCrc));
+            else out.put(indented(fields[keys[i]]));
+            out.put(i + 1 < keys.size() ? ",\n" : "\n");
+        }
+        out.put("}");
+        out.flush();
+        return true;
+    }
+
+    // 写出一个分段：先占位分段头，写完内容后回填长度和校验和
+    template <typename Func>
+    static void writeSection(SaveIO::AtomicFile& file, Sink& out, const string& name, Func content) {
+        out.put(static_cast<char>(name.size()));
+        out.put(name);
+        out.flush();
+        long headerPos = file.tell();
+        out.put(string(8, '\0'));
+        out.restart();
+
+        content(out);
+        out.flush();
+
+        string header;
+        SaveCodec::putU32(header, static_cast<uint32_t>(out.size()));
+        SaveCodec::putU32(header, out.checksum());
+        file.seek(headerPos);
+        file.write(header);
+        file.seekEnd();
+    }
+
+    static bool writeMsgpack(SaveIO::AtomicFile& file, const json& fields, const InventoryImage& items) {
+        Sink out(file);
+        out.put(SaveCodec::MAGIC, sizeof(SaveCodec::MAGIC));
+        out.put(static_cast<char>(SaveCodec::VERSION));
+        out.put(static_cast<char>(SaveFormat::MSGPACK));
+        out.put('\0');
+        out.put('\0');
+
+        auto isSection = [](const string& key) {
+            for (const char* section : SaveCodec::SECTIONS) {
+                if (key == section) return true;
+            }
+            return false;
+        };
+
+        vector<string> keys;
+        for (auto& field : fields.items()) {
+            if (!isSection(field.key())) keys.push_back(field.key());
+        }
+        keys.push_back("inventory");
+        sort(keys.begin(), keys.end());
+
+        writeSection(file, out, "main", [&](Sink& sink) {
+            putContainer(sink, 0x80, 0xDE, keys.size());
+            for (const string& key : keys) {
+                putStr(sink, key);
+                if (key == "inventory") {
+                    putInventoryMsgpack(sink, items);
+                } else {
+                    string bytes;
+                    json::to_msgpack(fields[key], bytes);
+                    sink.put(bytes);
+                }
+            }
+        });
+        for (const char* section : SaveCodec::SECTIONS) {
+            if (!fields.contains(section)) continue;
+            writeSection(file, out, section, [&](Sink& sink) {
+                string bytes;
+                json::to_msgpack(fields[section], bytes);
+                sink.put(bytes);
+            });
+        }
+        return true;
+    }
+
+public:
+    // fields: 除背包外的所有顶层字段；背包按 items 的顺序逐件写出
+    static bool write(const string& path, const json& fields, const InventoryImage& items, SaveFormat format) {
+        SaveIO::AtomicFile file(path);
+        if (!file.isOpen()) return false;
+        if (format == SaveFormat::JSON) writeJson(file, fields, items);
+        else writeMsgpack(file, fields, items);
+        return file.commit();
+    }
+};
+
+// 读档结果（背包中的装备通过回调逐件交给调用方）
+struct SaveReadResult {
+    json fields;                  // 除背包外的所有顶层字段；inventory 只保留空数组占位
+    size_t itemCount = 0;
+    SaveFormat format = SaveFormat::JSON;
+    vector<string> damaged;       // 校验失败而被丢弃的独立分段
+    size_t fileSize = 0;
+    uint32_t fileCrc = 0;         // 整个文件的 CRC32C（与元数据比较）
+    string error;
+};
+
+class SaveReader {
+public:
+    using ItemCallback = function<void(int tid, int lv, int rar)>;
+
+private:
+    // 读取时计算经过的字节数和校验和；limit 限制只读取一个分段
+    class ChecksumStreamBuf : public streambuf {
+    private:
+        FILE* file = nullptr;
+        streambuf* source = nullptr;
+        bool bounded = false;
+        size_t remaining = 0;
+        char buffer[64 * 1024];
+        uint32_t crc = 0;
+        size_t total = 0;
+
+    protected:
+        int_type underflow() override {
+            if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+            size_t want = sizeof(buffer);
+            if (bounded) want = min(want, remaining);
+            if (want == 0) return traits_type::eof();
+            size_t n = file ? fread(buffer, 1, want, file)
+                            : static_cast<size_t>(source->sgetn(buffer, static_cast<streamsize>(want)));
+            if (n == 0) return traits_type::eof();
+            if (bounded) remaining -= n;
+            crc = Checksum::crc32c(buffer, n, crc);
+            total += n;
+            setg(buffer, buffer, buffer + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    public:
+        explicit ChecksumStreamBuf(FILE* f) : file(f) {}
+        ChecksumStreamBuf(streambuf* from, size_t limit) : source(from), bounded(true), remaining(limit) {}
+
+        // 读完剩余内容，使校验和覆盖全部字节
+        void drain() {
+            while (underflow() != traits_type::eof()) setg(egptr(), egptr(), egptr());
+        }
+
+        uint32_t checksum() const {
+            return crc;
+        }
+
+        size_t size() const {
+            return total;
+        }
+    };
+
+    // 背包数组逐件回调，其余内容组装成 json
+    class Handler : public nlohmann::json_sax<json> {
+    private:
+        json& root;
+        const ItemCallback* onItem;   // 为空时不处理背包（独立分段）
+        vector<json*> stack;
+        std::string currentKey;
+        bool inventoryNext = false;   // 下一个值是顶层的 inventory
+        bool inInventory = false;
+        bool inItem = false;
+        std::string itemKey;
+        int tid = -1, lv = 1, rar = 0;
+
+        json* add(json&& value) {
+            inventoryNext = false;
+            if (stack.empty()) {
+                root = move(value);
+                return &root;
+            }
+            json& parent = *stack.back();
+            if (parent.is_array()) {
+                parent.push_back(move(value));
+                return &parent.back();
+            }
+            json& slot = parent[currentKey];
+            slot = move(value);
+            return &slot;
+        }
+
+        bool scalar(json&& value) {
+            if (inItem) {
+                if (!value.is_number_integer()) return true;  // 与旧版一样忽略未知字段
+                int v = value.get<int>();
+                if (itemKey == "tid") tid = v;
+                else if (itemKey == "lv") lv = v;
+                else if (itemKey == "rar") rar = v;
+                return true;
+            }
+            if (inInventory) return fail("背包中有无效的装备记录");
+            add(move(value));
+            return true;
+        }
+
+        bool fail(const std::string& message) {
+            error = message;
+            return false;
+        }
+
+    public:
+        size_t itemCount = 0;
+        std::string error;
+
+        Handler(json& target, const ItemCallback* callback) : root(target), onItem(callback) {}
+
+        bool null() override { return scalar(json()); }
+        bool boolean(bool val) override { return scalar(json(val)); }
+        bool number_integer(number_integer_t val) override { return scalar(json(val)); }
+        bool number_unsigned(number_unsigned_t val) override { return scalar(json(val)); }
+        bool number_float(number_float_t val, const string_t&) override { return scalar(json(val)); }
+        bool string(string_t& val) override { return scalar(json(move(val))); }
+        bool binary(binary_t& val) override { return scalar(json::binary(move(val))); }
+
+        bool start_object(size_t) override {
+            if (inItem) return fail("装备记录格式错误");
+            if (inInventory) {
+                inItem = true;
+                tid = -1;
+                lv = 1;
+                rar = 0;
+                return true;
+            }
+            stack.push_back(add(json::object()));
+            return true;
+        }
+
+        bool key(string_t& val) override {
+            if (inItem) {
+                itemKey = val;
+                return true;
+            }
+            currentKey = val;
+            inventoryNext = onItem && stack.size() == 1 && val == "inventory";
+            return true;
+        }
+
+        bool end_object() override {
+            if (inItem) {
+                inItem = false;
+                if (tid < 0) return fail("装备记录缺少 tid");
+                (*onItem)(tid, lv, rar);
+                itemCount++;
+                return true;
+            }
+            stack.pop_back();
+            return true;
+        }
+
+        bool start_array(size_t) override {
+            if (inItem || inInventory) return fail("装备记录格式错误");
+            if (inventoryNext) {
+                add(json::array());   // 占位，表示存档中有背包
+                inInventory = true;
+                return true;
+            }
+            stack.push_back(add(json::array()));
+            return true;
+        }
+
+        bool end_array() override {
+            if (inInventory) {
+                inInventory = false;
+                return true;
+            }
+            stack.pop_back();
+            return true;
+        }
+
+        bool parse_error(size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+            return fail(ex.what());
+        }
+    };
+
+    static bool readSections(istream& in, streambuf* fileBuf, SaveReadResult& result, const ItemCallback& onItem) {
+        bool sawMain = false;
+        bool truncated = false;
+        while (true) {
+            int nameLen = in.get();
+            if (nameLen == EOF) break;
+            std::string name(static_cast<size_t>(nameLen), '\0');
+            char head[8];
+            if (!in.read(&name[0], nameLen) || !in.read(head, sizeof(head))) {
+                truncated = true;
+                break;
+            }
+            size_t size = SaveCodec::readU32(head);
+            uint32_t crc = SaveCodec::readU32(head + 4);
+
+            ChecksumStreamBuf frameBuf(fileBuf, size);
+            istream frameIn(&frameBuf);
+            json content;
+            Handler handler(content, sawMain ? nullptr : &onItem);
+            bool parsed = json::sax_parse(frameIn, &handler, json::input_format_t::msgpack, true);
+            frameBuf.drain();
+            bool complete = frameBuf.size() == size;
+            bool intact = parsed && complete && frameBuf.checksum() == crc;
+
+            if (!sawMain) {
+                // 玩家数据段损坏：调用方需丢弃已回调的装备
+                if (!intact || !content.is_object()) {
+                    result.error = "玩家数据校验和不一致";
+                    return false;
+                }
+                result.fields = move(content);
+                result.itemCount = handler.itemCount;
+                sawMain = true;
+            } else if (intact) {
+                result.fields[name] = move(content);
+            } else {
+                result.damaged.push_back(name);
+            }
+            if (!complete) {
+                truncated = true;
+                break;
+            }
+        }
+        if (!sawMain) {
+            result.error = "二进制存档不完整";
+            return false;
+        }
+        if (truncated) {
+            for (const char* section : SaveCodec::SECTIONS) {
+                if (!result.fields.contains(section) &&
+                    find(result.damaged.begin(), result.damaged.end(), section) == result.damaged.end()) {
+                    result.damaged.push_back(section);
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    // 流式读取存档；返回 false 时 result.error 给出原因，已回调的装备应由调用方丢弃
+    static bool read(const std::string& path, SaveReadResult& result, const ItemCallback& onItem) {
+        result = SaveReadResult();
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) {
+            result.error = "无法打开存档文件";
+            return false;
+        }
+        char header[SaveCodec::HEADER_SIZE];
+        size_t headerLen = fread(header, 1, sizeof(header), f);
+        rewind(f);
+
+        ChecksumStreamBuf fileBuf(f);
+        istream in(&fileBuf);
+        bool ok;
+        if (!SaveCodec::hasHeader(std::string(header, headerLen))) {
+            result.format = SaveFormat::JSON;
+            Handler handler(result.fields, &onItem);
+            ok = json::sax_parse(in, &handler, json::input_format_t::json, true) && result.fields.is_object();
+            if (ok) {
+                result.itemCount = handler.itemCount;
+                SaveCodec::checkSections(result.fields, result.damaged);
+            } else {
+                result.error = "JSON 解析失败";
+            }
+        } else {
+            in.read(header, sizeof(header));
+            uint8_t version = static_cast<uint8_t>(header[4]);
+            uint8_t encoding = static_cast<uint8_t>(header[5]);
+            result.format = SaveFormat::MSGPACK;
+            if (version > SaveCodec::VERSION) {
+                result.error = "存档格式版本 " + to_string(version) + " 高于当前程序支持的版本";
+                ok = false;
+            } else if (encoding != static_cast<uint8_t>(SaveFormat::MSGPACK)) {
+                result.error = "未知的存档编码 " + to_string(encoding);
+                ok = false;
+            } else if (version >= 2) {
+                ok = readSections(in, &fileBuf, result, onItem);
+            } else {
+                Handler handler(result.fields, &onItem);
+                ok = json::sax_parse(in, &handler, json::input_format_t::msgpack, true) && result.fields.is_object();
+                if (ok) result.itemCount = handler.itemCount;
+                else result.error = "二进制存档解析失败";
+            }
+        }
+        fileBuf.drain();
+        result.fileSize = fileBuf.size();
+        result.fileCrc = fileBuf.checksum();
+        fclose(f);
+        return ok;
+    }
+};
+
+#endif // SAVE_STREAM_H
@@ -0,0 +1,103 @@
+/**
+ * 文件名: SaveWorker.h
+ * 职责: 后台存档线程 - 按提交顺序在单个工作线程中执行文件写入
+ *
+ * 界面线程只负责生成快照并提交写入任务，序列化、fsync 和重命名都在后台完成，
+ * 不会阻塞玩家输入。任务严格按提交顺序执行，因此日志追加与快照写入不会乱序。
+ * 未调用 start() 时（例如命令行工具）任务直接在当前线程执行。
+ */
+
+#ifndef SAVE_WORKER_H
+#define SAVE_WORKER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+using namespace std;
+
+class SaveWorker {
+private:
+    thread worker;
+    mutex lock;
+    condition_variable wake;   // 有新任务或要求停止
+    condition_variable idle;   // 队列已清空
+    deque<function<void()>> tasks;
+    bool running = false;
+    bool busy = false;
+    bool stopping = false;
+
+    static SaveWorker& instance() {
+        static SaveWorker w;
+        return w;
+    }
+
+    void run() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) break;  // stopping 且已无任务
+            function<void()> task = move(tasks.front());
+            tasks.pop_front();
+            busy = true;
+            guard.unlock();
+            task();
+            guard.lock();
+            busy = false;
+            if (tasks.empty()) idle.notify_all();
+        }
+    }
+
+    ~SaveWorker() {
+        stop();
+    }
+
+public:
+    static void start() {
+        SaveWorker& w = instance();
+        lock_guard<mutex> guard(w.lock);
+        if (w.running) return;
+        w.stopping = false;
+        w.running = true;
+        w.worker = thread([&w]() { w.run(); });
+    }
+
+    static void submit(function<void()> task) {
+        SaveWorker& w = instance();
+        {
+            lock_guard<mutex> guard(w.lock);
+            if (w.running) {
+                w.tasks.push_back(move(task));
+                w.wake.notify_one();
+                return;
+            }
+        }
+        task();
+    }
+
+    // 等待已提交的任务全部写完（退出游戏前调用）
+    static void flush() {
+        SaveWorker& w = instance();
+        unique_lock<mutex> guard(w.lock);
+        w.idle.wait(guard, [&w]() { return !w.running || (w.tasks.empty() && !w.busy); });
+    }
+
+    // 写完剩余任务后结束线程
+    static void stop() {
+        SaveWorker& w = instance();
+        {
+            lock_guard<mutex> guard(w.lock);
+            if (!w.running) return;
+            w.stopping = true;
+            w.wake.notify_one();
+        }
+        w.worker.join();
+        lock_guard<mutex> guard(w.lock);
+        w.running = false;
+        w.idle.notify_all();
+    }
+};
+
+#endif // SAVE_WORKER_H
@@ -1,6 +1,6 @@
 /**
  * 文件名: Shop.h
- * 职责: 商店系统 - 装备购买、商品刷新
+ * 职责: 商店系统 - 装备购买、商品刷新（货架件数、稀有度权重、价格由 ShopConfig 配置，见 ShopCatalogue.h）
  */
 
 #ifndef SHOP_H
@@ -8,30 +8,59 @@
 
 #include <iostream>
 #include <vector>
-#include <random>
-#include <ctime>
+#include <deque>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <chrono>
+#include <future>
 #include <iomanip>
+#include <functional>
+#include <memory>
+#include "json.hpp"
 #include "GameCore.h"
+#include "ShopCatalogue.h"
+#include "ShopRng.h"
+#include "ShopRoller.h"
+#include "ShopTelemetry.h"
+#include "ShopRestock.h"
+
+using json = nlohmann::json;
 
 using namespace std;
 
-// 商店物品结构
-struct ShopItem {
-    Equipment* equipment;
+// 商店商品：只记录上架的是哪个模板、什么等级和价格，购买时才生成背包里的装备
+// 模板由模板库持有（SaveManager::itemLibrary），商品不拥有它，因此商品可以随意复制
+struct ShopOffer {
+    int templateId;
+    int level;
+    Rarity rarity;
     int price;
-    
-    ShopItem(Equipment* eq, int p) : equipment(eq), price(p) {}
+    const Equipment* source;  // 对应的装备模板
+
+    ShopOffer(const Equipment* tmpl, int lv, int p)
+        : templateId(tmpl->getId()), level(lv), rarity(tmpl->getRarity()), price(p), source(tmpl) {}
 };
 
 // 商店类
+// 模板目录、配置和抽取表在 ShopProfile 中，由同一类的所有商店共享；商店本身只保存商品、随机数状态和刷新费用
+// 第 n 次刷新的商品只由种子和 n 决定（ShopRng），后台线程（ShopRoller）提前算好接下来几次的结果，
+// 刷新时直接取队首；算好的结果随商店状态保存，读档后接下来的商品不变
+// 自动补货按补货时钟（RestockClock）计算：访问时才补货，错过多个周期时直接跳过中间的序号，只刷新一次
 class Shop {
 private:
-    vector<ShopItem> items;           // 当前商店物品
-    vector<Equipment*> allEquipments; // 所有可用装备模板
-    mt19937 rng;
+    vector<ShopOffer> items;                 // 当前上架的商品
+    shared_ptr<const ShopProfile> profile;   // 共享的模板目录、配置和抽取表
+    uint64_t seed;                           // 随机数种子
+    uint64_t nextRoll = 0;                   // 下一次刷新的序号（upcoming 队首对应的序号）
+    deque<vector<ShopOffer>> upcoming;       // 已算好的后续刷新结果
+    shared_future<vector<vector<ShopOffer>>> pending;  // 后台正在计算的结果（紧接在 upcoming 之后）
     bool needsRefresh;                // 是否需要刷新
+    uint64_t stockedAt = 0;           // 上次补货所在周期的起点（补货时钟读数，单位见配置）
     int manualRefreshCost;            // 手动刷新费用
-    
+
     // 获取稀有度对应的颜色代码
     string getRarityColor(Rarity r) const {
         switch(r) {
@@ -42,126 +71,244 @@ private:
             default: return "\033[37m";
         }
     }
-    
-    // 计算装备价格
-    int calculatePrice(Equipment* eq) const {
-        return 500 * (static_cast<int>(eq->getRarity()) + 1);
-    }
-    
+
     // 根据稀有度概率选择装备
-    // 概率: BROKEN 50%, STANDARD 30%, MILITARY 15%, LEGENDARY 5%
-    Equipment* selectEquipmentByRarity() {
-        if (allEquipments.empty()) return nullptr;
-        
-        // 按稀有度分类装备
-        vector<Equipment*> brokenItems, standardItems, militaryItems, legendaryItems;
-        for (auto eq : allEquipments) {
-            switch(eq->getRarity()) {
-                case Rarity::BROKEN: brokenItems.push_back(eq); break;
-                case Rarity::STANDARD: standardItems.push_back(eq); break;
-                case Rarity::MILITARY: militaryItems.push_back(eq); break;
-                case Rarity::LEGENDARY: legendaryItems.push_back(eq); break;
+    // 默认概率: BROKEN 50%, STANDARD 30%, MILITARY 15%, LEGENDARY 5%
+    // 稀有度用别名表抽取，池内等概率抽取，每次 O(1)
+    static Equipment* selectEquipmentByRarity(const ShopProfile& profile, ShopRng& rng) {
+        const AliasTable& sampler = profile.raritySampler();
+        if (sampler.empty()) return nullptr;
+
+        size_t column = static_cast<size_t>(rng.below(sampler.size()));
+        const vector<Equipment*>& pool = profile.getCatalogue().pool(static_cast<int>(sampler.sample(column, rng.unit())));
+        return pool[rng.below(pool.size())];
+    }
+
+    // 按权重不放回地抽取最多 count 件不同的模板
+    // 逐件抽取，抽中的模板退出候选：结果分布与"抽到重复就重抽、直到抽满"相同，但不需要重试，
+    // 每件只需看 4 个稀有度的剩余权重和已抽中的件数，与模板总数无关。模板不足 count 件时全部抽完为止
+    static vector<Equipment*> sampleDistinct(const ShopProfile& profile, ShopRng& rng, size_t count) {
+        const ShopCatalogue& catalogue = profile.getCatalogue();
+        vector<Equipment*> picked;
+        vector<size_t> taken[4];  // 各池已抽中的下标（升序）
+        while (picked.size() < count) {
+            // 同一稀有度内每件模板的权重相同，剩余权重 = 单件权重 × 剩余件数
+            double remaining[4];
+            double total = 0;
+            for (int r = BROKEN; r <= LEGENDARY; r++) {
+                size_t poolSize = catalogue.pool(r).size();
+                size_t left = poolSize - taken[r].size();
+                remaining[r] = left ? static_cast<double>(profile.poolWeight(r)) * left / poolSize : 0;
+                total += remaining[r];
+            }
+            if (total <= 0) break;
+
+            double x = rng.unit() * total;
+            int r = -1;
+            for (int i = BROKEN; i <= LEGENDARY; i++) {
+                if (remaining[i] <= 0) continue;
+                r = i;
+                if (x < remaining[i]) break;
+                x -= remaining[i];
             }
+
+            // 在未抽中的模板里等概率取第 k 件，跳过已抽中的下标换算成池内下标
+            const vector<Equipment*>& pool = catalogue.pool(r);
+            size_t k = static_cast<size_t>(rng.below(pool.size() - taken[r].size()));
+            auto pos = taken[r].begin();
+            while (pos != taken[r].end() && *pos <= k) {
+                k++;
+                ++pos;
+            }
+            taken[r].insert(pos, k);
+            picked.push_back(pool[k]);
         }
-        
-        // 生成 0-99 的随机数
-        uniform_int_distribution<int> rarityDist(0, 99);
-        int roll = rarityDist(rng);
-        
-        vector<Equipment*>* selectedPool = nullptr;
-        
-        if (roll < 50 && !brokenItems.empty()) {
-            // 0-49: BROKEN (50%)
-            selectedPool = &brokenItems;
-        } else if (roll < 80 && !standardItems.empty()) {
-            // 50-79: STANDARD (30%)
-            selectedPool = &standardItems;
-        } else if (roll < 95 && !militaryItems.empty()) {
-            // 80-94: MILITARY (15%)
-            selectedPool = &militaryItems;
-        } else if (!legendaryItems.empty()) {
-            // 95-99: LEGENDARY (5%)
-            selectedPool = &legendaryItems;
+        return picked;
+    }
+
+    // 第 index 次刷新的商品：只读共享数据，可在后台线程中执行
+    static vector<ShopOffer> rollOffers(const ShopProfile& profile, uint64_t seed, uint64_t index) {
+        ShopRng rng(seed, index);
+        vector<ShopOffer> offers;
+
+        // 不放回抽取不重复的装备
+        size_t slots = static_cast<size_t>(profile.getConfig().slots);
+        for (Equipment* template_eq : sampleDistinct(profile, rng, slots)) {
+            offers.push_back(ShopOffer(template_eq, 1, profile.priceOf(template_eq->getRarity())));
         }
-        
-        // 如果选中的池子为空，回退到其他池子
-        if (!selectedPool || selectedPool->empty()) {
-            if (!standardItems.empty()) selectedPool = &standardItems;
-            else if (!brokenItems.empty()) selectedPool = &brokenItems;
-            else if (!militaryItems.empty()) selectedPool = &militaryItems;
-            else if (!legendaryItems.empty()) selectedPool = &legendaryItems;
-            else return nullptr;
+
+        // 如果装备种类不足货架件数，允许重复
+        while (offers.size() < slots) {
+            Equipment* template_eq = selectEquipmentByRarity(profile, rng);
+            if (!template_eq) break;
+            offers.push_back(ShopOffer(template_eq, 1, profile.priceOf(template_eq->getRarity())));
         }
-        
-        // 从选中的池子中随机选择一个
-        uniform_int_distribution<int> itemDist(0, selectedPool->size() - 1);
-        return (*selectedPool)[itemDist(rng)];
+        return offers;
     }
-    
+
+    // 把后台算好的结果接到队尾；wait 为 false 时只取已经算完的
+    void collectPending(bool wait) {
+        if (!pending.valid()) return;
+        if (!wait && pending.wait_for(chrono::seconds(0)) != future_status::ready) return;
+        for (const auto& offers : pending.get()) upcoming.push_back(offers);
+        pending = shared_future<vector<vector<ShopOffer>>>();
+    }
+
+    // 队列不足配置的件数时，把缺少的几次交给后台线程计算
+    void scheduleRolls() {
+        size_t target = static_cast<size_t>(profile->getConfig().preroll);
+        if (pending.valid() || upcoming.size() >= target) return;
+        // 模板目录和抽取表在当前线程就绪，后台只读取
+        profile->raritySampler();
+        shared_ptr<const ShopProfile> shared = profile;
+        uint64_t shopSeed = seed;
+        uint64_t from = nextRoll + upcoming.size();
+        size_t count = target - upcoming.size();
+        pending = ShopRoller::submit<vector<vector<ShopOffer>>>([shared, shopSeed, from, count]() {
+            vector<vector<ShopOffer>> results;
+            for (size_t i = 0; i < count; i++) results.push_back(rollOffers(*shared, shopSeed, from + i));
+            return results;
+        });
+    }
+
+    static json offersToJson(const vector<ShopOffer>& offers) {
+        json array = json::array();
+        for (const auto& item : offers) {
+            json itemJson;
+            itemJson["equipment_id"] = item.templateId;
+            itemJson["equipment_level"] = item.level;
+            itemJson["price"] = item.price;
+            array.push_back(itemJson);
+        }
+        return array;
+    }
+
+    // 模板已不存在的商品跳过
+    static vector<ShopOffer> offersFromJson(const json& array, const function<Equipment*(int)>& findTemplate) {
+        vector<ShopOffer> offers;
+        for (const auto& itemJson : array) {
+            int equipId = itemJson["equipment_id"];
+            int equipLevel = itemJson.value("equipment_level", 1);
+            int price = itemJson["price"];
+            
+            // 查找对应的装备模板
+            Equipment* template_eq = findTemplate(equipId);
+            
+            if (template_eq) {
+                offers.push_back(ShopOffer(template_eq, equipLevel, price));
+            }
+        }
+        return offers;
+    }
+
+    // 丢弃算好的结果（模板目录或种子变化后不再有效）
+    void discardRolls() {
+        upcoming.clear();
+        pending = shared_future<vector<vector<ShopOffer>>>();
+    }
+
+    // 跳过接下来 count 次刷新：只移动序号，不计算被跳过的商品
+    void skipRolls(uint64_t count) {
+        if (count == 0) return;
+        collectPending(false);
+        if (count < upcoming.size()) {
+            upcoming.erase(upcoming.begin(), upcoming.begin() + static_cast<ptrdiff_t>(count));
+        } else {
+            discardRolls();
+        }
+        nextRoll += count;
+    }
+
 public:
-    Shop(const vector<Equipment*>& equipmentTemplates) 
-        : allEquipments(equipmentTemplates), needsRefresh(true), manualRefreshCost(50) {
-        rng.seed(static_cast<unsigned int>(time(nullptr)));
+    // 使用共享的模板目录和配置（大量商店时每类商店只构建一份 ShopProfile）
+    // 默认种子只由商店 id 决定；游戏中由存档槽位和商店 id 推导（见 ShopRng::seedFor），读档时以存档为准
+    Shop(shared_ptr<const ShopProfile> shopProfile)
+        : profile(move(shopProfile)), seed(ShopRng::seedFor("", profile->getConfig().id)), needsRefresh(true),
+          manualRefreshCost(profile->getConfig().refreshCost) {}
+
+    // 单独使用一组模板
+    Shop(const vector<Equipment*>& equipmentTemplates, const ShopConfig& shopConfig = ShopConfig())
+        : Shop(ShopProfile::create(ShopCatalogue::fromTemplates(equipmentTemplates), shopConfig)) {}
+
+    // 延迟加载模板：直到第一次刷新才向模板来源请求（内容包按需加载）
+    Shop(function<vector<Equipment*>()> source, const ShopConfig& shopConfig = ShopConfig())
+        : Shop(ShopProfile::create(ShopCatalogue::fromSource(move(source)), shopConfig)) {}
+
+    // 换用新的模板目录或配置（内容热更新）：已上架的商品不变，之后的刷新按新目录重新计算
+    void setProfile(shared_ptr<const ShopProfile> shopProfile) {
+        profile = move(shopProfile);
+        discardRolls();
     }
-    
-    // 刷新商店（随机3件装备，避免重复）
+
+    const shared_ptr<const ShopProfile>& getProfile() const {
+        return profile;
+    }
+
+    // 设置随机数种子：之后的刷新从序号 0 开始按新种子计算
+    void setSeed(uint64_t newSeed) {
+        seed = newSeed;
+        nextRoll = 0;
+        discardRolls();
+    }
+
+    uint64_t getSeed() const {
+        return seed;
+    }
+
+    // 刷新商店（随机上架配置的件数，避免重复）
     void refresh() {
-        // 清空旧物品
-        for (auto& item : items) {
-            delete item.equipment;
-        }
         items.clear();
-        
-        if (allEquipments.empty()) {
+
+        if (profile->getCatalogue().empty()) {
             cout << "[错误] 没有可用的装备模板！" << endl;
             return;
         }
-        
-        // 随机选择3件不重复的装备
-        vector<int> selectedIds; // 记录已选择的装备ID，避免重复
-        int attempts = 0;
-        const int maxAttempts = 100; // 防止无限循环
-        
-        while (items.size() < 3 && attempts < maxAttempts) {
-            Equipment* template_eq = selectEquipmentByRarity();
-            if (!template_eq) break;
-            
-            // 检查是否已经选择过这个ID
-            bool isDuplicate = false;
-            for (int id : selectedIds) {
-                if (id == template_eq->getId()) {
-                    isDuplicate = true;
-                    break;
-                }
-            }
-            
-            if (!isDuplicate) {
-                Equipment* eq = template_eq->clone(template_eq->getName(), 1);
-                int price = calculatePrice(eq);
-                items.push_back(ShopItem(eq, price));
-                selectedIds.push_back(template_eq->getId());
-            }
-            
-            attempts++;
-        }
-        
-        // 如果装备种类不足3种，允许重复
-        if (items.size() < 3) {
-            while (items.size() < 3) {
-                Equipment* template_eq = selectEquipmentByRarity();
-                if (!template_eq) break;
-                Equipment* eq = template_eq->clone(template_eq->getName(), 1);
-                int price = calculatePrice(eq);
-                items.push_back(ShopItem(eq, price));
-            }
+
+        // 优先取提前算好的结果，队列为空时等后台算完，没有后台任务时现算
+        collectPending(upcoming.empty());
+        if (upcoming.empty()) {
+            items = rollOffers(*profile, seed, nextRoll);
+        } else {
+            items = move(upcoming.front());
+            upcoming.pop_front();
         }
-        
+        nextRoll++;
+        scheduleRolls();
+        if (ShopTelemetry::enabled()) ShopTelemetry::record(profile->getConfig().id, items);
+
         needsRefresh = false;
         // 自然刷新时重置手动刷新费用
-        manualRefreshCost = 50;
+        manualRefreshCost = profile->getConfig().refreshCost;
         cout << "[系统] 商店已刷新！" << endl;
     }
-    
+
+    // 按补货时钟自动补货（访问商店时调用）
+    // 距上次补货经过 k 个周期时，跳过中间的 k - 1 次刷新，直接上架第 k 次的商品：
+    // 结果与每个周期都刷新一次相同，但只计算一次，与错过多少个周期无关
+    // 返回是否刷新了商品
+    bool restock(const RestockClock& clock) {
+        const ShopConfig& config = profile->getConfig();
+        uint64_t now = clock.now(config.restockUnit);
+        uint64_t period = static_cast<uint64_t>(max(config.restockPeriod, 1));
+        if (now < stockedAt) {
+            stockedAt = now;  // 时钟回退（例如系统时间被调整），从现在重新计时
+        }
+        uint64_t missed = (now - stockedAt) / period;
+        if (missed > 0) {
+            skipRolls(missed - 1);
+            stockedAt += missed * period;
+            needsRefresh = true;
+        }
+        if (!needsRefresh) return false;
+        refresh();
+        return true;
+    }
+
+    // 上次补货所在周期的起点
+    uint64_t getStockedAt() const {
+        return stockedAt;
+    }
+
     // 手动刷新商店（花费EXP）
     bool manualRefresh(int& playerExp) {
         if (playerExp < manualRefreshCost) {
@@ -175,8 +322,9 @@ public:
         // 刷新商店
         refresh();
         
-        // 翻倍刷新费用
-        manualRefreshCost *= 2;
+        // 刷新费用按配置的倍数上涨，在 long long 中计算并封顶，避免溢出成负数反而增加 EXP
+        long long nextCost = static_cast<long long>(manualRefreshCost) * profile->getConfig().refreshCostMultiplier;
+        manualRefreshCost = static_cast<int>(min<long long>(nextCost, numeric_limits<int>::max()));
         cout << "[提示] 下次手动刷新费用: " << manualRefreshCost << " EXP" << endl;
         
         return true;
@@ -186,6 +334,11 @@ public:
     int getManualRefreshCost() const {
         return manualRefreshCost;
     }
+
+    // 每次刷新上架的件数（菜单按此显示购买选项）
+    int getSlotCount() const {
+        return profile->getConfig().slots;
+    }
     
     // 显示商店
     void display() const {
@@ -196,8 +349,10 @@ public:
         }
         
         for (size_t i = 0; i < items.size(); i++) {
-            Equipment* eq = items[i].equipment;
-            string color = getRarityColor(eq->getRarity());
+            // 按购买后得到的装备显示属性（只在显示时生成，不保存）
+            unique_ptr<Equipment> preview(items[i].source->clone(items[i].source->getName(), items[i].level));
+            Equipment* eq = preview.get();
+            string color = getRarityColor(items[i].rarity);
             
             cout << "[" << (i + 1) << "] " << color << eq->getName() << "\033[0m";
             
@@ -228,35 +383,81 @@ public:
     
     // 购买物品
     bool buyItem(int index, int& playerExp, vector<Equipment*>& inventory) {
-        if (index < 0 || index >= static_cast<int>(items.size())) {
+        return buyItems(vector<int>{index}, playerExp, inventory);
+    }
+
+    // 批量购买（编号从 0 开始，不能重复）：一次校验总价，要么全部买下，要么一件都不买
+    // 装备全部生成后才扣除 EXP、放入背包并下架，中途失败不会留下买了一半的状态
+    bool buyItems(vector<int> indices, int& playerExp, vector<Equipment*>& inventory) {
+        sort(indices.begin(), indices.end());
+        bool valid = !indices.empty() && indices.front() >= 0 && indices.back() < static_cast<int>(items.size()) &&
+                     adjacent_find(indices.begin(), indices.end()) == indices.end();
+        if (!valid) {
             cout << "[错误] 无效的选择！" << endl;
             return false;
         }
         
-        ShopItem& item = items[index];
-        
-        // 检查经验值是否足够
-        if (playerExp < item.price) {
-            cout << "[错误] EXP 不足！需要 " << item.price << " EXP，当前只有 " << playerExp << " EXP。" << endl;
+        // 检查经验值是否足够（只检查一次总价）
+        long long total = 0;
+        for (int index : indices) total += items[index].price;
+        if (playerExp < total) {
+            cout << "[错误] EXP 不足！需要 " << total << " EXP，当前只有 " << playerExp << " EXP。" << endl;
             return false;
         }
         
-        // 扣除经验值
-        playerExp -= item.price;
-        
-        // 添加到背包
-        Equipment* purchased = item.equipment->clone(item.equipment->getName(), item.equipment->getLevel());
-        inventory.push_back(purchased);
+        // 购买时才由模板生成装备，与读档时由模板恢复的装备完全相同
+        vector<unique_ptr<Equipment>> purchased;
+        purchased.reserve(indices.size());
+        for (int index : indices) {
+            const ShopOffer& item = items[index];
+            purchased.emplace_back(item.source->clone(item.source->getName(), item.level));
+        }
+        inventory.reserve(inventory.size() + purchased.size());
         
-        cout << "[成功] 购买了 " << item.equipment->getName() << "！" << endl;
+        // 扣除经验值，放入背包
+        playerExp -= static_cast<int>(total);
+        if (purchased.size() == 1) {
+            cout << "[成功] 购买了 " << purchased.front()->getName() << "！" << endl;
+        } else {
+            cout << "[成功] 购买了 " << purchased.size() << " 件装备：";
+            for (size_t i = 0; i < purchased.size(); i++) {
+                cout << (i ? "、" : "") << purchased[i]->getName();
+            }
+            cout << "，共花费 " << total << " EXP" << endl;
+        }
+        for (auto& eq : purchased) inventory.push_back(eq.release());
         cout << "[系统] 剩余 EXP: " << playerExp << endl;
         
-        // 从商店移除该物品
-        delete item.equipment;
-        items.erase(items.begin() + index);
+        // 从商店移除这些物品
+        vector<ShopOffer> remaining;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (!binary_search(indices.begin(), indices.end(), static_cast<int>(i))) remaining.push_back(items[i]);
+        }
+        items.swap(remaining);
         
         return true;
     }
+
+    // 买下当前全部商品（脚本和机器人用）；EXP 不够买全部时一件都不买
+    bool buyAll(int& playerExp, vector<Equipment*>& inventory) {
+        vector<int> indices(items.size());
+        for (size_t i = 0; i < items.size(); i++) indices[i] = static_cast<int>(i);
+        return buyItems(indices, playerExp, inventory);
+    }
+
+    // 读取一行商品编号（从 1 开始，空格分隔），返回从 0 开始的编号；空行表示取消
+    static vector<int> readSelection(istream& in) {
+        cout << "请输入要购买的商品编号（空格分隔，直接回车取消）: ";
+        string line;
+        in.ignore(numeric_limits<streamsize>::max(), '\n');
+        getline(in, line);
+        vector<int> indices;
+        istringstream words(line);
+        int number;
+        while (words >> number) indices.push_back(number - 1);
+        if (!words.eof()) indices.push_back(-1);  // 夹杂非数字时整体视为无效
+        return indices;
+    }
     
     // 标记需要刷新
     void markNeedsRefresh() {
@@ -274,63 +475,62 @@ public:
     }
     
     // 序列化商店状态（用于存档）
+    // upcoming 只保存已算好的结果；后台尚未取回的部分读档后按种子和序号重新计算，结果相同
     json toJson() const {
         json j;
         j["needs_refresh"] = needsRefresh;
         j["manual_refresh_cost"] = manualRefreshCost;
-        
-        json itemsArray = json::array();
-        for (const auto& item : items) {
-            json itemJson;
-            itemJson["equipment_id"] = item.equipment->getId();
-            itemJson["equipment_level"] = item.equipment->getLevel();
-            itemJson["price"] = item.price;
-            itemsArray.push_back(itemJson);
+        j["items"] = offersToJson(items);
+        j["seed"] = seed;
+        j["next_roll"] = nextRoll;
+        j["stocked_at"] = stockedAt;
+        json upcomingArray = json::array();
+        for (const auto& offers : upcoming) {
+            upcomingArray.push_back(offersToJson(offers));
         }
-        j["items"] = itemsArray;
+        j["upcoming"] = upcomingArray;
         
         return j;
     }
     
     // 从 JSON 加载商店状态
-    void fromJson(const json& j, const vector<Equipment*>& equipmentTemplates) {
-        // 清空旧物品
-        for (auto& item : items) {
-            delete item.equipment;
-        }
-        items.clear();
-        
+    // findTemplate: 按 id 查找装备模板（只加载商品需要的模板）
+    // 旧存档没有 seed 时保留当前的种子（读档前由槽位推导），从序号 0 开始
+    void fromJson(const json& j, function<Equipment*(int)> findTemplate) {
         needsRefresh = j.value("needs_refresh", true);
-        manualRefreshCost = j.value("manual_refresh_cost", 50);
-        
-        if (j.contains("items")) {
-            for (const auto& itemJson : j["items"]) {
-                int equipId = itemJson["equipment_id"];
-                int equipLevel = itemJson.value("equipment_level", 1);
-                int price = itemJson["price"];
-                
-                // 查找对应的装备模板
-                Equipment* template_eq = nullptr;
-                for (auto eq : equipmentTemplates) {
-                    if (eq->getId() == equipId) {
-                        template_eq = eq;
-                        break;
-                    }
-                }
-                
-                if (template_eq) {
-                    Equipment* eq = template_eq->clone(template_eq->getName(), equipLevel);
-                    items.push_back(ShopItem(eq, price));
+        // 费用只会从配置的初始值上涨，手动改成更小（或负数）的值时按初始值计算
+        manualRefreshCost = max(j.value("manual_refresh_cost", profile->getConfig().refreshCost),
+                                profile->getConfig().refreshCost);
+        items = j.contains("items") ? offersFromJson(j["items"], findTemplate) : vector<ShopOffer>();
+        // 旧存档没有补货记录时从时钟起点算起（旧存档的冒险和战斗时钟也从 0 开始）
+        stockedAt = j.value("stocked_at", static_cast<uint64_t>(0));
+
+        discardRolls();
+        if (j.contains("seed") && j["seed"].is_number_unsigned()) {
+            seed = j["seed"].get<uint64_t>();
+            nextRoll = j.value("next_roll", static_cast<uint64_t>(0));
+            if (j.contains("upcoming") && j["upcoming"].is_array()) {
+                for (const auto& offers : j["upcoming"]) {
+                    upcoming.push_back(offersFromJson(offers, findTemplate));
                 }
             }
+        } else {
+            nextRoll = 0;
         }
     }
-    
-    // 析构函数
-    ~Shop() {
-        for (auto& item : items) {
-            delete item.equipment;
+
+    // 已算好、尚未上架的刷新次数（包括后台已算完但还没取回的）
+    size_t getUpcomingCount() const {
+        size_t count = upcoming.size();
+        if (pending.valid() && pending.wait_for(chrono::seconds(0)) == future_status::ready) {
+            count += pending.get().size();
         }
+        return count;
+    }
+
+    // 当前上架的商品（只读）
+    const vector<ShopOffer>& getOffers() const {
+        return items;
     }
 };
 
@@ -0,0 +1,434 @@
+/**
+ * 文件名: ShopBench.cpp
+ * 职责: 商店刷新性能测试 - 比较旧的逐次分桶抽取与预先分池 + 别名表抽取
+ *
+ * 用法: ShopBench [模板数量] [刷新次数]      默认 10000 个模板、20000 次刷新
+ *       ShopBench --verify [刷新次数]         默认 200000 次，检验不放回抽取的分布
+ *       ShopBench --many [商店数] [模板数量]   默认 10000 个商店共享 10000 个模板，测量每个商店的内存和刷新耗时
+ * 旧方式: 每次抽取都遍历全部模板重新分成 4 个稀有度桶，再掷 0-99 决定稀有度（即改动前的 Shop 实现）。
+ * 新方式: Shop::refresh()，稀有度池在模板就绪时构建一次，每件商品的抽取与模板总数无关。
+ * 另外对几种缺少部分稀有度的模板库比较两种方式抽到的稀有度分布，确认空池回退规则不变。
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <map>
+#include <array>
+#include <cstring>
+#include "GameCore.h"
+#include "Shop.h"
+#include "ShopFixtures.h"
+
+using namespace std;
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// 改动前的实现：每次调用都重新分桶
+static Equipment* legacySelect(const vector<Equipment*>& allEquipments, mt19937& rng) {
+    if (allEquipments.empty()) return nullptr;
+    vector<Equipment*> brokenItems, standardItems, militaryItems, legendaryItems;
+    for (auto eq : allEquipments) {
+        switch (eq->getRarity()) {
+            case Rarity::BROKEN: brokenItems.push_back(eq); break;
+            case Rarity::STANDARD: standardItems.push_back(eq); break;
+            case Rarity::MILITARY: militaryItems.push_back(eq); break;
+            case Rarity::LEGENDARY: legendaryItems.push_back(eq); break;
+        }
+    }
+    uniform_int_distribution<int> rarityDist(0, 99);
+    int roll = rarityDist(rng);
+    vector<Equipment*>* selectedPool = nullptr;
+    if (roll < 50 && !brokenItems.empty()) selectedPool = &brokenItems;
+    else if (roll < 80 && !standardItems.empty()) selectedPool = &standardItems;
+    else if (roll < 95 && !militaryItems.empty()) selectedPool = &militaryItems;
+    else if (!legendaryItems.empty()) selectedPool = &legendaryItems;
+    if (!selectedPool || selectedPool->empty()) {
+        if (!standardItems.empty()) selectedPool = &standardItems;
+        else if (!brokenItems.empty()) selectedPool = &brokenItems;
+        else if (!militaryItems.empty()) selectedPool = &militaryItems;
+        else if (!legendaryItems.empty()) selectedPool = &legendaryItems;
+        else return nullptr;
+    }
+    uniform_int_distribution<int> itemDist(0, selectedPool->size() - 1);
+    return (*selectedPool)[itemDist(rng)];
+}
+
+// 改动前的刷新：3 件不重复，最多尝试 100 次
+static void legacyRefresh(const vector<Equipment*>& allEquipments, mt19937& rng, vector<Equipment*>& items) {
+    for (auto eq : items) delete eq;
+    items.clear();
+    vector<int> selectedIds;
+    int attempts = 0;
+    while (items.size() < 3 && attempts < 100) {
+        Equipment* t = legacySelect(allEquipments, rng);
+        if (!t) break;
+        bool isDuplicate = false;
+        for (int id : selectedIds) {
+            if (id == t->getId()) {
+                isDuplicate = true;
+                break;
+            }
+        }
+        if (!isDuplicate) {
+            items.push_back(t->clone(t->getName(), 1));
+            selectedIds.push_back(t->getId());
+        }
+        attempts++;
+    }
+    while (items.size() < 3) {
+        Equipment* t = legacySelect(allEquipments, rng);
+        if (!t) break;
+        items.push_back(t->clone(t->getName(), 1));
+    }
+}
+
+// 刷新后商品的稀有度
+static void countShopRarities(const Shop& shop, long counts[4]) {
+    for (const ShopOffer& offer : shop.getOffers()) counts[static_cast<int>(offer.rarity)]++;
+}
+
+// 按改动前的规则（掷点，空池顺延、再回退）算出各稀有度分到的点数；odds 为配置的稀有度权重
+static void legacyRarityWeights(const vector<Equipment*>& lib, const int odds[4], int weights[4]) {
+    bool present[4] = {false, false, false, false};
+    for (auto eq : lib) present[static_cast<int>(eq->getRarity())] = true;
+    for (int r = 0; r < 4; r++) weights[r] = 0;
+    int total = odds[0] + odds[1] + odds[2] + odds[3];
+    for (int roll = 0; roll < total; roll++) {
+        int r = -1;
+        if (roll < odds[0] && present[0]) r = 0;
+        else if (roll < odds[0] + odds[1] && present[1]) r = 1;
+        else if (roll < odds[0] + odds[1] + odds[2] && present[2]) r = 2;
+        else if (present[3]) r = 3;
+        if (r < 0) {
+            for (int f : {1, 0, 2, 3}) {
+                if (present[f]) { r = f; break; }
+            }
+        }
+        if (r >= 0) weights[r]++;
+    }
+}
+
+// 连续刷新 count 次，记录每次上架的模板 id
+static vector<vector<int>> recordRefreshes(Shop& shop, int count) {
+    ostringstream sink;
+    streambuf* console = cout.rdbuf(sink.rdbuf());
+    vector<vector<int>> result;
+    for (int i = 0; i < count; i++) {
+        shop.refresh();
+        vector<int> ids;
+        for (const ShopOffer& offer : shop.getOffers()) ids.push_back(offer.templateId);
+        result.push_back(ids);
+    }
+    cout.rdbuf(console);
+    return result;
+}
+
+// 按补货时钟补货：时钟每前进一个单位补货一次的商店，与闲置后一次追赶的商店最终商品相同
+static bool verifyRestockCatchUp(const vector<Equipment*>& lib, const ShopConfig& base, int periods) {
+    ShopConfig config = base;
+    config.restockUnit = RestockUnit::BATTLE;
+    config.restockPeriod = 3;
+
+    ostringstream sink;
+    streambuf* console = cout.rdbuf(sink.rdbuf());
+    RestockClock clock;
+    Shop stepped(lib, config);
+    Shop idle(lib, config);
+    stepped.restock(clock);
+    idle.restock(clock);
+    int steppedRefreshes = 0;
+    for (int i = 0; i < periods * config.restockPeriod; i++) {
+        clock.advance(RestockUnit::BATTLE);
+        if (stepped.restock(clock)) steppedRefreshes++;
+    }
+    bool idleRefreshed = idle.restock(clock);
+    cout.rdbuf(console);
+
+    vector<int> a, b;
+    for (const ShopOffer& offer : stepped.getOffers()) a.push_back(offer.templateId);
+    for (const ShopOffer& offer : idle.getOffers()) b.push_back(offer.templateId);
+    return steppedRefreshes == periods && idleRefreshed && a == b && stepped.getStockedAt() == idle.getStockedAt();
+}
+
+// 可复现性：同一种子的商店不论是否提前计算、是否在后台计算、中途是否存读档，刷新结果都相同
+static bool verifyReproducible() {
+    const int share[4] = {25, 25, 25, 25};
+    vector<Equipment*> lib = ShopFixtures::makeTemplates(200, share, "Bench");
+    auto findTemplate = [&lib](int id) -> Equipment* {
+        for (auto eq : lib) if (eq->getId() == id) return eq;
+        return nullptr;
+    };
+    ShopConfig inline0;
+    inline0.preroll = 0;
+    ShopConfig ahead;
+    ahead.preroll = 4;
+    const int rounds = 40;
+
+    Shop reference(lib, inline0);
+    reference.setSeed(20260101);
+    vector<vector<int>> expected = recordRefreshes(reference, rounds);
+
+    Shop prerolled(lib, ahead);
+    prerolled.setSeed(20260101);
+    bool samePreroll = recordRefreshes(prerolled, rounds) == expected;
+
+    ShopRoller::start();
+    Shop background(lib, ahead);
+    background.setSeed(20260101);
+    bool sameBackground = recordRefreshes(background, rounds) == expected;
+
+    // 刷新到一半保存，再读入新商店继续刷新
+    Shop first(lib, ahead);
+    first.setSeed(20260101);
+    vector<vector<int>> resumed = recordRefreshes(first, rounds / 2);
+    json saved = first.toJson();
+    Shop second(lib, ahead);
+    second.fromJson(saved, findTemplate);
+    vector<vector<int>> rest = recordRefreshes(second, rounds - rounds / 2);
+    resumed.insert(resumed.end(), rest.begin(), rest.end());
+    bool sameAfterReload = resumed == expected && saved["upcoming"].size() <= 4;
+    ShopRoller::stop();
+
+    Shop otherSeed(lib, inline0);
+    otherSeed.setSeed(20260102);
+    bool differentSeed = recordRefreshes(otherSeed, rounds) != expected;
+
+    bool sameCatchUp = verifyRestockCatchUp(lib, inline0, 1000) && verifyRestockCatchUp(lib, ahead, 2);
+
+    cout << "\n可复现性（" << rounds << " 次刷新）" << endl;
+    cout << "  提前计算与现算一致: " << (samePreroll ? "通过" : "未通过") << endl;
+    cout << "  后台线程计算一致: " << (sameBackground ? "通过" : "未通过") << endl;
+    cout << "  中途存读档后一致: " << (sameAfterReload ? "通过" : "未通过") << endl;
+    cout << "  不同种子结果不同: " << (differentSeed ? "通过" : "未通过") << endl;
+    cout << "  闲置后一次补货与逐次补货一致: " << (sameCatchUp ? "通过" : "未通过") << endl;
+    for (auto eq : lib) delete eq;
+    return samePreroll && sameBackground && sameAfterReload && differentSeed && sameCatchUp;
+}
+
+// 不放回抽取的统计检验：对每个商品位置，比较实际抽到的模板频数与精确概率（卡方检验，显著性 0.1%）
+static int runVerify(int samples) {
+    struct Case { const char* name; int share[4]; int odds[4]; size_t slots; };
+    const Case cases[] = {
+        {"偏斜的小模板库 (1/4/1/2)", {1, 4, 1, 2}, {50, 30, 15, 5}, 3},
+        {"没有损坏级 (0/3/2/1)", {0, 3, 2, 1}, {50, 30, 15, 5}, 3},
+        {"模板少于货架 (0/1/0/1)", {0, 1, 0, 1}, {50, 30, 15, 5}, 3},
+        {"只有传奇 (0/0/0/3)", {0, 0, 0, 3}, {50, 30, 15, 5}, 3},
+        {"活动商店: 6 件，权重 10/20/30/40", {2, 3, 2, 2}, {10, 20, 30, 40}, 6},
+    };
+    ostringstream sink;
+    streambuf* console = cout.rdbuf();
+    bool allPassed = true;
+
+    cout << "\n不放回抽取分布检验（每种模板库 " << samples << " 次刷新，卡方检验，显著性 0.1%）" << endl;
+    for (const Case& c : cases) {
+        int count = c.share[0] + c.share[1] + c.share[2] + c.share[3];
+        vector<Equipment*> lib = ShopFixtures::makeTemplates(count, c.share, "Bench");
+        const size_t slots = c.slots;
+        ShopConfig config;
+        config.slots = static_cast<int>(slots);
+        for (int r = 0; r < 4; r++) config.rarityWeights[r] = c.odds[r];
+
+        // 期望分布使用按改动前规则算出的稀有度点数，不依赖被检验的抽取表
+        int rarityWeights[4];
+        legacyRarityWeights(lib, c.odds, rarityWeights);
+        array<double, 4> weight;
+        for (int r = 0; r < 4; r++) weight[r] = rarityWeights[r];
+        vector<vector<double>> expected = ShopFixtures::templateByPosition(lib, weight, slots);
+        map<int, size_t> indexOf;
+        for (size_t i = 0; i < lib.size(); i++) indexOf[lib[i]->getId()] = i;
+
+        vector<vector<long>> observed(slots, vector<long>(lib.size(), 0));
+        long duplicates = 0;
+        Shop shop(lib, config);
+        cout.rdbuf(sink.rdbuf());
+        for (int i = 0; i < samples; i++) {
+            shop.refresh();
+            sink.str("");
+            vector<bool> seen(lib.size(), false);
+            size_t pos = 0;
+            for (const ShopOffer& offer : shop.getOffers()) {
+                size_t idx = indexOf[offer.templateId];
+                if (pos < slots) observed[pos][idx]++;
+                if (seen[idx]) duplicates++;
+                seen[idx] = true;
+                pos++;
+            }
+        }
+        cout.rdbuf(console);
+
+        cout << c.name << endl;
+        for (size_t pos = 0; pos < slots; pos++) {
+            double chi2 = 0;
+            int df = -1;
+            for (size_t i = 0; i < lib.size(); i++) {
+                double e = expected[pos][i] * samples;
+                if (e <= 0) continue;
+                chi2 += (observed[pos][i] - e) * (observed[pos][i] - e) / e;
+                df++;
+            }
+            bool passed = df <= 0 ? chi2 == 0 : chi2 < ShopTelemetry::chiSquareCritical(df);
+            allPassed = allPassed && passed;
+            cout << "  第 " << (pos + 1) << " 件: 卡方 " << fixed << setprecision(2) << chi2
+                 << "，自由度 " << df;
+            if (df > 0) cout << "，临界值 " << ShopTelemetry::chiSquareCritical(df);
+            cout << (passed ? "  通过" : "  未通过") << endl;
+        }
+        // 模板足够时同一次刷新不应出现重复
+        if (count >= static_cast<int>(slots) && duplicates > 0) {
+            allPassed = false;
+            cout << "  [错误] 出现 " << duplicates << " 次重复商品" << endl;
+        }
+        for (auto eq : lib) delete eq;
+    }
+    allPassed = verifyReproducible() && allPassed;
+    cout << (allPassed ? "\n[系统] 全部检验通过。" : "\n[错误] 存在未通过的检验！") << endl;
+    return allPassed ? 0 : 1;
+}
+
+// 大量商店共享一份模板目录：每个商店只占自己的商品、随机数状态和刷新费用
+static int runMany(size_t shopCount, size_t templateCount) {
+    const int fullShare[4] = {25, 25, 25, 25};
+    vector<Equipment*> templates = ShopFixtures::makeTemplates(templateCount, fullShare, "Bench");
+    shared_ptr<const ShopProfile> profile = ShopProfile::create(ShopCatalogue::fromTemplates(templates), ShopConfig());
+
+    ostringstream sink;
+    streambuf* console = cout.rdbuf();
+    auto start = chrono::steady_clock::now();
+    vector<Shop> shops(shopCount, Shop(profile));
+    double createMs = elapsedMs(start);
+
+    cout.rdbuf(sink.rdbuf());
+    start = chrono::steady_clock::now();
+    for (Shop& shop : shops) {
+        shop.refresh();
+        sink.str("");
+    }
+    double refreshMs = elapsedMs(start);
+
+    // 闲置的商店不随时钟更新：时钟前进一百万个补货周期后逐个访问，每个商店只补货一次
+    const uint64_t idlePeriods = 1000000;
+    RestockClock clock;
+    clock.advance(RestockUnit::ADVENTURE, idlePeriods);
+    start = chrono::steady_clock::now();
+    for (Shop& shop : shops) {
+        shop.restock(clock);
+        sink.str("");
+    }
+    double restockMs = elapsedMs(start);
+    cout.rdbuf(console);
+
+    // 商品、补货记录和提前算好的刷新结果（deque 的块开销另计）
+    size_t perShop = sizeof(Shop) + shops.front().getOffers().capacity() * sizeof(ShopOffer) +
+                     shops.front().getUpcomingCount() * (sizeof(vector<ShopOffer>) + 3 * sizeof(ShopOffer));
+    // 改动前每个商店复制一份模板列表，并各自分池（两份指针）
+    size_t copiedPerShop = templateCount * sizeof(Equipment*) * 2;
+
+    cout << "\n商店数: " << shopCount << "，共享模板: " << templateCount << endl;
+    cout << "创建耗时: " << fixed << setprecision(2) << createMs << " ms，全部刷新一次: " << refreshMs << " ms" << endl;
+    cout << "闲置 " << idlePeriods << " 个补货周期后全部访问一次: " << restockMs << " ms" << endl;
+    cout << "每个商店约 " << perShop << " 字节（其中随机数状态为种子和刷新序号 16 字节），共约 "
+         << setprecision(1) << perShop * shopCount / 1048576.0 << " MB" << endl;
+    cout << "每个商店复制模板列表时另需约 " << copiedPerShop << " 字节，共约 "
+         << copiedPerShop * shopCount / 1048576.0 << " MB" << endl;
+
+    shops.clear();
+    for (auto eq : templates) delete eq;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        return runVerify(argc > 2 ? atoi(argv[2]) : 200000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--many") == 0) {
+        return runMany(argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000,
+                       argc > 3 ? strtoul(argv[3], nullptr, 10) : 10000);
+    }
+
+    size_t templateCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+    int refreshes = argc > 2 ? atoi(argv[2]) : 20000;
+
+    // refresh() 每次都会输出提示，测试期间丢弃
+    ostringstream sink;
+    streambuf* console = cout.rdbuf();
+
+    const int fullShare[4] = {25, 25, 25, 25};
+    vector<Equipment*> templates = ShopFixtures::makeTemplates(templateCount, fullShare, "Bench");
+
+    mt19937 rng(12345);
+    vector<Equipment*> legacyItems;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < refreshes; i++) legacyRefresh(templates, rng, legacyItems);
+    double legacyMs = elapsedMs(start);
+    for (auto eq : legacyItems) delete eq;
+
+    Shop shop(templates);
+    cout.rdbuf(sink.rdbuf());
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < refreshes; i++) {
+        shop.refresh();
+        sink.str("");
+    }
+    double newMs = elapsedMs(start);
+    cout.rdbuf(console);
+
+    cout << "\n模板数量: " << templateCount << "，刷新次数: " << refreshes << endl;
+    cout << "方式                 总耗时(ms)     刷新/秒" << endl;
+    cout << left << setw(21) << "旧: 逐次分桶" << right << fixed << setprecision(2)
+         << setw(10) << legacyMs << setw(14) << setprecision(0) << refreshes / (legacyMs / 1000) << endl;
+    cout << left << setw(21) << "新: 预分池抽取" << right << setprecision(2)
+         << setw(10) << newMs << setw(14) << setprecision(0) << refreshes / (newMs / 1000) << endl;
+    for (auto eq : templates) delete eq;
+
+    // 稀有度分布：两种方式在各种模板组合下应一致（按 3 件商品计，含去重的影响）
+    struct Case { const char* name; int share[4]; };
+    const Case cases[] = {
+        {"四种稀有度齐全", {25, 25, 25, 25}},
+        {"没有损坏级", {0, 40, 40, 20}},
+        {"只有军用和传奇", {0, 0, 50, 50}},
+        {"只有传奇", {0, 0, 0, 100}},
+    };
+    const int samples = 20000;
+    cout << "\n稀有度分布（" << samples << " 次刷新，损坏/普通/军用/传奇，%）" << endl;
+    for (const Case& c : cases) {
+        vector<Equipment*> lib = ShopFixtures::makeTemplates(200, c.share, "Bench");
+        long legacyCounts[4] = {0, 0, 0, 0}, newCounts[4] = {0, 0, 0, 0};
+
+        mt19937 legacyRng(7);
+        vector<Equipment*> items;
+        for (int i = 0; i < samples; i++) {
+            legacyRefresh(lib, legacyRng, items);
+            for (auto eq : items) legacyCounts[static_cast<int>(eq->getRarity())]++;
+        }
+        for (auto eq : items) delete eq;
+
+        Shop libShop(lib);
+        cout.rdbuf(sink.rdbuf());
+        for (int i = 0; i < samples; i++) {
+            libShop.refresh();
+            sink.str("");
+            countShopRarities(libShop, newCounts);
+        }
+        cout.rdbuf(console);
+
+        auto printRow = [](const char* label, const long counts[4]) {
+            long total = counts[0] + counts[1] + counts[2] + counts[3];
+            cout << "  " << left << setw(8) << label << right << setprecision(1);
+            for (int r = 0; r < 4; r++) cout << setw(8) << (total ? 100.0 * counts[r] / total : 0);
+            cout << endl;
+        };
+        cout << c.name << endl;
+        printRow("旧", legacyCounts);
+        printRow("新", newCounts);
+        for (auto eq : lib) delete eq;
+    }
+    return 0;
+}
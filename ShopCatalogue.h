@@ -0,0 +1,143 @@
+/**
+ * 文件名: ShopCatalogue.h
+ * 职责: 商店共享数据 - 按稀有度分好池的装备模板目录（ShopCatalogue），
+ *       以及目录 + 商店配置 + 稀有度抽取表（ShopProfile）
+ *
+ * 两者构建后只读，通过 shared_ptr 在任意多个商店之间共享：每个商店只保存自己的商品、随机数状态和刷新费用。
+ * 目录可以延迟加载（内容包按需加载）：第一次用到时才向模板来源请求，多个线程同时访问时只加载一次。
+ * 模板对象由模板库（SaveManager::itemLibrary）持有，目录只保存指针；
+ * 替换模板（内容热更新）时构建新的目录和配置交给商店，旧目录在最后一个引用它的商店换掉后释放。
+ */
+
+#ifndef SHOP_CATALOGUE_H
+#define SHOP_CATALOGUE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include "GameCore.h"
+#include "AliasTable.h"
+#include "ShopConfig.h"
+
+using namespace std;
+
+// 装备模板目录：按稀有度分池，下标为 Rarity
+class ShopCatalogue {
+private:
+    mutable once_flag loadOnce;
+    mutable function<vector<Equipment*>()> source;  // 延迟加载的模板来源，加载后清空
+    mutable vector<Equipment*> templates;
+    mutable vector<Equipment*> pools[4];
+
+    struct Token {};
+
+    void ensureLoaded() const {
+        call_once(loadOnce, [this]() {
+            if (source) {
+                templates = source();
+                source = nullptr;
+            }
+            for (auto eq : templates) {
+                pools[static_cast<int>(eq->getRarity())].push_back(eq);
+            }
+        });
+    }
+
+public:
+    ShopCatalogue(Token, vector<Equipment*> list, function<vector<Equipment*>()> loader)
+        : source(move(loader)), templates(move(list)) {}
+
+    static shared_ptr<const ShopCatalogue> fromTemplates(const vector<Equipment*>& list) {
+        return make_shared<const ShopCatalogue>(Token{}, list, nullptr);
+    }
+
+    // 延迟加载：直到第一次用到模板才调用 loader
+    static shared_ptr<const ShopCatalogue> fromSource(function<vector<Equipment*>()> loader) {
+        return make_shared<const ShopCatalogue>(Token{}, vector<Equipment*>(), move(loader));
+    }
+
+    const vector<Equipment*>& pool(int rarity) const {
+        ensureLoaded();
+        return pools[rarity];
+    }
+
+    bool empty() const {
+        ensureLoaded();
+        return templates.empty();
+    }
+
+    size_t size() const {
+        ensureLoaded();
+        return templates.size();
+    }
+};
+
+// 一类商店的共享规则：模板目录、配置，以及按配置和目录构建的稀有度抽取表
+class ShopProfile {
+private:
+    shared_ptr<const ShopCatalogue> catalogue;
+    ShopConfig config;
+    mutable once_flag buildOnce;
+    mutable int weights[4] = {0, 0, 0, 0};  // 各稀有度池分到的权重（已计入空池回退），池内每件模板均分
+    mutable AliasTable sampler;             // 稀有度的抽取表
+
+    struct Token {};
+
+    // 抽中稀有度 tier 时实际使用的池子：该池为空时顺延到更高的稀有度，
+    // 都为空时按 STANDARD、BROKEN、MILITARY、LEGENDARY 的顺序回退；没有任何模板时返回 -1
+    int poolForTier(int tier) const {
+        for (int r = tier; r <= LEGENDARY; r++) {
+            if (!catalogue->pool(r).empty()) return r;
+        }
+        for (int r : {STANDARD, BROKEN, MILITARY, LEGENDARY}) {
+            if (!catalogue->pool(r).empty()) return r;
+        }
+        return -1;
+    }
+
+    // 把配置的稀有度权重按空池规则汇总到实际的池子上，构建抽取表
+    // 与逐次掷点再按规则回退的结果分布完全相同，但只在目录就绪时计算一次
+    void ensureBuilt() const {
+        call_once(buildOnce, [this]() {
+            for (int tier = BROKEN; tier <= LEGENDARY; tier++) {
+                int pool = poolForTier(tier);
+                if (pool >= 0) weights[pool] += config.rarityWeights[tier];
+            }
+            sampler.build(vector<double>(weights, weights + 4));
+        });
+    }
+
+public:
+    ShopProfile(Token, shared_ptr<const ShopCatalogue> cat, const ShopConfig& cfg)
+        : catalogue(move(cat)), config(cfg) {}
+
+    static shared_ptr<const ShopProfile> create(shared_ptr<const ShopCatalogue> cat, const ShopConfig& cfg) {
+        return make_shared<const ShopProfile>(Token{}, move(cat), cfg);
+    }
+
+    const ShopConfig& getConfig() const {
+        return config;
+    }
+
+    const ShopCatalogue& getCatalogue() const {
+        return *catalogue;
+    }
+
+    // 稀有度 r 的池子分到的权重
+    int poolWeight(int r) const {
+        ensureBuilt();
+        return weights[r];
+    }
+
+    const AliasTable& raritySampler() const {
+        ensureBuilt();
+        return sampler;
+    }
+
+    int priceOf(Rarity rarity) const {
+        return config.prices[static_cast<int>(rarity)];
+    }
+};
+
+#endif // SHOP_CATALOGUE_H
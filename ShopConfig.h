@@ -0,0 +1,202 @@
+/**
+ * 文件名: ShopConfig.h
+ * 职责: 商店配置 - 货架件数、稀有度权重、价格表、手动刷新费用和补货周期按商店 id 从数据文件读取
+ *
+ * 配置文件格式 (shops.json):
+ * {
+ *     "shops": {
+ *         "base": {
+ *             "slots": 3,
+ *             "rarity_weights": {"BROKEN": 50, "STANDARD": 30, "MILITARY": 15, "LEGENDARY": 5},
+ *             "prices": {"BROKEN": 500, "STANDARD": 1000, "MILITARY": 1500, "LEGENDARY": 2000},
+ *             "refresh_cost": 50,
+ *             "refresh_cost_multiplier": 2,
+ *             "preroll": 3,
+ *             "restock_unit": "adventure",
+ *             "restock_period": 1
+ *         },
+ *         "campfire": { ... }
+ *     }
+ * }
+ * 每个字段都可以省略，省略时使用默认值（即上面的数值）。文件不存在时所有商店使用默认配置；
+ * 某个商店的配置无效时只有该商店回退到默认配置。稀有度权重不要求总和为 100，按比例计算。
+ * restock_unit 为补货计时单位：adventure（冒险次数）、battle（战斗次数）或 second（现实时间，秒），
+ * 每经过 restock_period 个单位自动补货一次。
+ * 配置在启动时读取一次，之后商店只使用构建好的抽取表和价格表。
+ */
+
+#ifndef SHOP_CONFIG_H
+#define SHOP_CONFIG_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <map>
+#include <limits>
+#include "json.hpp"
+#include "GameCore.h"
+#include "DataValidator.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+// 补货计时单位
+enum class RestockUnit {
+    ADVENTURE,  // 完成的冒险次数
+    BATTLE,     // 进行的战斗次数
+    SECOND      // 现实时间（秒）
+};
+
+// 单个商店的配置
+struct ShopConfig {
+    string id = "default";
+    int slots = 3;                             // 每次刷新上架的件数
+    int rarityWeights[4] = {50, 30, 15, 5};    // 稀有度权重，下标为 Rarity
+    int prices[4] = {500, 1000, 1500, 2000};   // 各稀有度的售价（EXP），下标为 Rarity
+    int refreshCost = 50;                      // 手动刷新的初始费用，自然刷新后恢复为该值
+    int refreshCostMultiplier = 2;             // 每次手动刷新后费用乘以该倍数
+    int preroll = 3;                           // 后台提前算好的刷新次数（0 表示刷新时现算）
+    RestockUnit restockUnit = RestockUnit::ADVENTURE;  // 补货计时单位
+    int restockPeriod = 1;                     // 每经过多少个单位补货一次
+
+    static constexpr int MAX_SLOTS = 20;
+    static constexpr int MAX_PREROLL = 16;
+};
+
+class ShopConfigs {
+public:
+    // 读取配置文件；文件不存在时保持默认配置
+    static void load(const string& filename) {
+        configs().clear();
+        ifstream f(filename);
+        if (!f.is_open()) return;
+
+        json j;
+        try {
+            j = json::parse(f);
+        } catch (json::parse_error& e) {
+            cout << "[警告] 商店配置 " << filename << " 解析失败，使用默认配置: " << e.what() << endl;
+            return;
+        }
+        if (!j.contains("shops") || !j["shops"].is_object()) {
+            cout << "[警告] 商店配置 " << filename << " 缺少 shops 对象，使用默认配置。" << endl;
+            return;
+        }
+
+        for (auto it = j["shops"].begin(); it != j["shops"].end(); ++it) {
+            ShopConfig config;
+            config.id = it.key();
+            string error;
+            if (!parse(it.value(), config, error)) {
+                cout << "[警告] 商店配置 " << config.id << " 无效（" << error << "），该商店使用默认配置。" << endl;
+                continue;
+            }
+            configs()[config.id] = config;
+        }
+        cout << "[系统] 商店配置加载完毕，共 " << configs().size() << " 个商店。" << endl;
+    }
+
+    static bool parseRestockUnit(const string& name, RestockUnit& out) {
+        if (name == "adventure") out = RestockUnit::ADVENTURE;
+        else if (name == "battle") out = RestockUnit::BATTLE;
+        else if (name == "second") out = RestockUnit::SECOND;
+        else return false;
+        return true;
+    }
+
+    static const char* restockUnitName(RestockUnit unit) {
+        switch (unit) {
+            case RestockUnit::ADVENTURE: return "adventure";
+            case RestockUnit::BATTLE: return "battle";
+            case RestockUnit::SECOND: return "second";
+        }
+        return "adventure";
+    }
+
+    // 按商店 id 取配置，没有配置时返回默认配置
+    static ShopConfig get(const string& id) {
+        auto it = configs().find(id);
+        if (it != configs().end()) return it->second;
+        ShopConfig config;
+        config.id = id;
+        return config;
+    }
+
+private:
+    static map<string, ShopConfig>& configs() {
+        static map<string, ShopConfig> table;
+        return table;
+    }
+
+    static bool readInt(const json& item, const char* key, int minValue, int& out, string& error) {
+        if (!item.contains(key)) return true;
+        if (!item[key].is_number_integer() || item[key].get<long long>() < minValue ||
+            item[key].get<long long>() > 1000000000) {
+            error = string(key) + " 应为不小于 " + to_string(minValue) + " 的整数";
+            return false;
+        }
+        out = item[key].get<int>();
+        return true;
+    }
+
+    // 读取按稀有度名称给出的表，未给出的稀有度保持原值
+    static bool readRarityTable(const json& item, const char* key, int minValue, int out[4], string& error) {
+        if (!item.contains(key)) return true;
+        if (!item[key].is_object()) {
+            error = string(key) + " 应为对象";
+            return false;
+        }
+        for (auto it = item[key].begin(); it != item[key].end(); ++it) {
+            Rarity r;
+            if (!DataValidator::parseRarity(it.key(), r)) {
+                error = string(key) + " 中有未知稀有度 " + it.key();
+                return false;
+            }
+            if (!readInt(item[key], it.key().c_str(), minValue, out[static_cast<int>(r)], error)) return false;
+        }
+        return true;
+    }
+
+    static bool parse(const json& item, ShopConfig& config, string& error) {
+        if (!item.is_object()) {
+            error = "应为对象";
+            return false;
+        }
+        if (!readInt(item, "slots", 1, config.slots, error)) return false;
+        if (config.slots > ShopConfig::MAX_SLOTS) {
+            error = "slots 不能超过 " + to_string(ShopConfig::MAX_SLOTS);
+            return false;
+        }
+        if (!readRarityTable(item, "rarity_weights", 0, config.rarityWeights, error)) return false;
+        // 每项最多 1e9，四项之和在 long long 中计算；总和还要放得进 int（抽取表按池累加权重）
+        long long weightSum = 0;
+        for (int r = 0; r < 4; r++) weightSum += config.rarityWeights[r];
+        if (weightSum <= 0) {
+            error = "rarity_weights 至少要有一个大于 0";
+            return false;
+        }
+        if (weightSum > numeric_limits<int>::max()) {
+            error = "rarity_weights 的总和不能超过 " + to_string(numeric_limits<int>::max());
+            return false;
+        }
+        if (!readRarityTable(item, "prices", 0, config.prices, error)) return false;
+        if (!readInt(item, "refresh_cost", 1, config.refreshCost, error)) return false;
+        if (!readInt(item, "refresh_cost_multiplier", 1, config.refreshCostMultiplier, error)) return false;
+        if (!readInt(item, "preroll", 0, config.preroll, error)) return false;
+        if (config.preroll > ShopConfig::MAX_PREROLL) {
+            error = "preroll 不能超过 " + to_string(ShopConfig::MAX_PREROLL);
+            return false;
+        }
+        if (item.contains("restock_unit")) {
+            if (!item["restock_unit"].is_string() ||
+                !parseRestockUnit(item["restock_unit"].get<string>(), config.restockUnit)) {
+                error = "restock_unit 应为 adventure、battle 或 second";
+                return false;
+            }
+        }
+        if (!readInt(item, "restock_period", 1, config.restockPeriod, error)) return false;
+        return true;
+    }
+};
+
+#endif // SHOP_CONFIG_H
@@ -0,0 +1,101 @@
+/**
+ * 文件名: ShopFixtures.h
+ * 职责: 商店检验工具的公共部分 - 合成模板库和各商品位置的精确概率
+ *
+ * ShopBench 和 ShopHarness 共用这里的模板工厂和期望分布，两个工具检验的是同一套规则。
+ * 精确概率按剩余权重逐位置递推（状态为各稀有度已抽中的件数），与模板总数无关：
+ * 同一稀有度池内各模板权重相同、可以互换，所以每件模板的概率等于所在稀有度的概率除以池大小。
+ */
+
+#ifndef SHOP_FIXTURES_H
+#define SHOP_FIXTURES_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include "GameCore.h"
+#include "StringPool.h"
+
+using namespace std;
+
+class ShopFixtures {
+public:
+    // 按稀有度比例（share 为各稀有度的份数）生成模板库，份数为 0 的稀有度没有模板
+    // id 从 10000 起连续编号，名称为 "<prefix>-<序号>"
+    static vector<Equipment*> makeTemplates(size_t count, const int share[4], const string& prefix) {
+        vector<Equipment*> templates;
+        string_view faction = StringPool::intern(prefix);
+        int total = share[0] + share[1] + share[2] + share[3];
+        for (size_t i = 0; i < count; i++) {
+            int slot = static_cast<int>(i % total);
+            int r = 0;
+            while (slot >= share[r]) slot -= share[r++];
+            string_view name = StringPool::intern(prefix + "-" + to_string(i));
+            templates.push_back(new Weapon(static_cast<int>(10000 + i), name, static_cast<Rarity>(r), 1, faction,
+                                           PooledStrings(), 100, 10, 2, 5));
+        }
+        return templates;
+    }
+
+    // 各位置稀有度的精确概率；weight 为各稀有度池分到的权重，poolSize 为池中模板数
+    // 逐件不放回抽取（池中剩余模板按原权重均分），全部模板抽完后剩余位置按原权重放回抽取，与 Shop 的规则相同
+    static vector<array<double, 4>> rarityByPosition(const array<double, 4>& weight, const array<size_t, 4>& poolSize,
+                                                     size_t slots) {
+        double weightSum = 0;
+        for (int r = 0; r < 4; r++) {
+            if (poolSize[r]) weightSum += weight[r];
+        }
+
+        vector<array<double, 4>> expected(slots, {0, 0, 0, 0});
+        map<array<size_t, 4>, double> layer;
+        layer[{0, 0, 0, 0}] = 1.0;
+        for (size_t pos = 0; pos < slots; pos++) {
+            map<array<size_t, 4>, double> next;
+            for (const auto& state : layer) {
+                array<double, 4> remaining;
+                double total = 0;
+                for (int r = 0; r < 4; r++) {
+                    size_t left = poolSize[r] - state.first[r];
+                    remaining[r] = left ? weight[r] * left / poolSize[r] : 0;
+                    total += remaining[r];
+                }
+                for (int r = 0; r < 4; r++) {
+                    if (total > 0) {
+                        if (remaining[r] <= 0) continue;
+                        double p = state.second * remaining[r] / total;
+                        expected[pos][r] += p;
+                        array<size_t, 4> taken = state.first;
+                        taken[r]++;
+                        next[taken] += p;
+                    } else if (poolSize[r] && weight[r] > 0) {
+                        // 模板已抽完，允许重复
+                        double p = state.second * weight[r] / weightSum;
+                        expected[pos][r] += p;
+                        next[state.first] += p;
+                    }
+                }
+            }
+            layer.swap(next);
+        }
+        return expected;
+    }
+
+    // 每个位置上各模板的精确概率（下标与 templates 相同）
+    static vector<vector<double>> templateByPosition(const vector<Equipment*>& templates,
+                                                     const array<double, 4>& weight, size_t slots) {
+        array<size_t, 4> poolSize = {0, 0, 0, 0};
+        for (auto eq : templates) poolSize[static_cast<int>(eq->getRarity())]++;
+        vector<array<double, 4>> rarity = rarityByPosition(weight, poolSize, slots);
+        vector<vector<double>> expected(slots, vector<double>(templates.size(), 0.0));
+        for (size_t pos = 0; pos < slots; pos++) {
+            for (size_t i = 0; i < templates.size(); i++) {
+                int r = static_cast<int>(templates[i]->getRarity());
+                expected[pos][i] = rarity[pos][r] / poolSize[r];
+            }
+        }
+        return expected;
+    }
+};
+
+#endif // SHOP_FIXTURES_H
@@ -0,0 +1,248 @@
+/**
+ * 文件名: ShopHarness.cpp
+ * 职责: 商店抽取验证工具 - 无界面地连续刷新商店，统计稀有度和模板分布并做卡方检验，报告刷新速度
+ *
+ * 用法: ShopHarness [选项]
+ *   --refreshes N      刷新次数（默认 1000000）
+ *   --shop ID          商店 id，按 shops.json 中的配置（默认 base）
+ *   --config FILE      商店配置文件（默认 shops.json，不存在时使用默认配置）
+ *   --data FILE        装备数据（默认 gamedata.json）
+ *   --synthetic N      不读装备数据，改用 N 个合成模板（稀有度平均分布）
+ *   --seed S           商店种子（默认 1）
+ *   --background       在后台线程预计算刷新结果（默认在当前线程计算）
+ *   --report FILE      另外把统计结果写成 JSON
+ *
+ * 检验（显著性 0.1%，任何一项未通过时返回 1）:
+ *   1. 每个商品位置的稀有度分布与精确概率一致。第 1 件的精确概率就是配置的稀有度权重（空池顺延后）；
+ *      之后的位置因为不放回抽取而偏离配置，精确概率按剩余权重逐位置递推得到
+ *   2. 同一稀有度内各模板的上架次数一致（同一次刷新不重复，实际方差比多项分布小，检验偏保守）
+ * 只依赖 GameCore、数据校验和商店头文件，不包含控制台界面和存档代码，可以在 Linux 上编译运行。
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "json.hpp"
+#include "GameCore.h"
+#include "DataLoader.h"
+#include "DataValidator.h"
+#include "Shop.h"
+#include "ShopFixtures.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+static const char* RARITY_NAMES[4] = {"损坏", "普通", "军用", "传奇"};
+
+// 校验通过的装备按文件中的顺序作为模板（DataValidator 把 id 重复的后一件标为无效，与游戏相同由先出现的一件生效）
+static vector<Equipment*> loadTemplates(const string& file) {
+    vector<Equipment*> templates;
+    ifstream f(file);
+    if (!f.is_open()) {
+        cout << "[错误] 找不到装备数据文件: " << file << endl;
+        return templates;
+    }
+    json j;
+    try {
+        j = json::parse(f);
+    } catch (json::parse_error& e) {
+        cout << "[JSON错误] 装备数据解析失败: " << e.what() << endl;
+        return templates;
+    }
+    if (!j.contains("equipments")) {
+        cout << "[错误] " << file << " 中没有 equipments" << endl;
+        return templates;
+    }
+    ValidationReport report;
+    DataValidator::validateEquipments(j["equipments"], "$.equipments", report);
+    report.print(cout);
+    for (size_t i = 0; i < report.equipmentValid.size(); i++) {
+        if (report.equipmentValid[i]) templates.push_back(DataLoader::createEquipment(j["equipments"][i], 0));
+    }
+    return templates;
+}
+
+struct Options {
+    uint64_t refreshes = 1000000;
+    string shopId = "base";
+    string configFile = "shops.json";
+    string dataFile = "gamedata.json";
+    size_t synthetic = 0;
+    uint64_t seed = 1;
+    bool background = false;
+    string reportFile;
+};
+
+static bool parseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--refreshes" && hasValue) opt.refreshes = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--shop" && hasValue) opt.shopId = argv[++i];
+        else if (arg == "--config" && hasValue) opt.configFile = argv[++i];
+        else if (arg == "--data" && hasValue) opt.dataFile = argv[++i];
+        else if (arg == "--synthetic" && hasValue) opt.synthetic = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && hasValue) opt.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--background") opt.background = true;
+        else if (arg == "--report" && hasValue) opt.reportFile = argv[++i];
+        else {
+            cout << "[错误] 无法识别的参数: " << arg << endl;
+            return false;
+        }
+    }
+    return opt.refreshes > 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        cout << "用法: ShopHarness [--refreshes N] [--shop ID] [--config FILE] [--data FILE] [--synthetic N]"
+                " [--seed S] [--background] [--report FILE]" << endl;
+        return 2;
+    }
+
+    ShopConfigs::load(opt.configFile);
+    ShopConfig config = ShopConfigs::get(opt.shopId);
+    // 合成模板：稀有度平均分布
+    const int evenShare[4] = {1, 1, 1, 1};
+    vector<Equipment*> templates = opt.synthetic ? ShopFixtures::makeTemplates(opt.synthetic, evenShare, "Harness")
+                                                 : loadTemplates(opt.dataFile);
+    if (templates.empty()) {
+        cout << "[错误] 没有可用的装备模板！" << endl;
+        return 2;
+    }
+
+    shared_ptr<const ShopProfile> profile = ShopProfile::create(ShopCatalogue::fromTemplates(templates), config);
+    Shop shop(profile);
+    shop.setSeed(opt.seed);
+    if (opt.background) ShopRoller::start();
+
+    // 刷新时的提示输出全部丢弃
+    ShopTelemetry::reset();
+    ShopTelemetry::enable(true);
+    cout.setstate(ios_base::badbit);
+    auto start = chrono::steady_clock::now();
+    for (uint64_t i = 0; i < opt.refreshes; i++) shop.refresh();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.clear();
+    ShopTelemetry::enable(false);
+    if (opt.background) ShopRoller::stop();
+
+    ShopTelemetry::Histogram h = ShopTelemetry::snapshot()[config.id];
+    size_t slots = static_cast<size_t>(config.slots);
+    array<double, 4> poolWeight;
+    array<size_t, 4> poolSize;
+    for (int r = 0; r < 4; r++) {
+        poolSize[r] = profile->getCatalogue().pool(r).size();
+        poolWeight[r] = profile->poolWeight(r);
+    }
+    vector<array<double, 4>> expected = ShopFixtures::rarityByPosition(poolWeight, poolSize, slots);
+    bool allPassed = true;
+    json report;
+
+    cout << fixed;
+    cout << "\n商店 " << config.id << "（" << slots << " 件货架），模板 " << templates.size() << " 个，种子 " << opt.seed << endl;
+    cout << "刷新 " << h.refreshes << " 次，耗时 " << setprecision(2) << seconds << " 秒，"
+         << setprecision(0) << h.refreshes / seconds << " 次/秒" << (opt.background ? "（后台预计算）" : "") << endl;
+    report["shop"] = config.id;
+    report["templates"] = templates.size();
+    report["refreshes"] = h.refreshes;
+    report["refreshes_per_second"] = h.refreshes / seconds;
+
+    // 配置、第 1 件的实际分布（应与配置一致）、全部商品的实际分布（不放回抽取会偏离配置）
+    double configSum = 0;
+    for (int r = 0; r < 4; r++) configSum += config.rarityWeights[r];
+    uint64_t offered = h.rarity[0] + h.rarity[1] + h.rarity[2] + h.rarity[3];
+    cout << "\n稀有度        配置     第1件理论  第1件实际   全部理论   全部实际    模板数" << endl;
+    json rarityReport = json::array();
+    for (int r = 0; r < 4; r++) {
+        double overallExpected = 0;
+        for (size_t pos = 0; pos < slots; pos++) overallExpected += expected[pos][r];
+        overallExpected /= slots;
+        double first = h.rarityByPosition.empty() ? 0 : 100.0 * h.rarityByPosition[0][r] / h.refreshes;
+        double overall = offered ? 100.0 * h.rarity[r] / offered : 0;
+        cout << "  " << left << setw(8) << RARITY_NAMES[r] << right << setprecision(2)
+             << setw(9) << 100.0 * config.rarityWeights[r] / configSum
+             << setw(11) << 100.0 * expected[0][r] << setw(11) << first
+             << setw(11) << 100.0 * overallExpected << setw(11) << overall
+             << setw(10) << profile->getCatalogue().pool(r).size() << endl;
+        rarityReport.push_back({{"rarity", RARITY_NAMES[r]},
+                                {"configured", config.rarityWeights[r] / configSum},
+                                {"expected_first", expected[0][r]},
+                                {"observed_first", first / 100},
+                                {"expected_overall", overallExpected},
+                                {"observed_overall", overall / 100}});
+    }
+    report["rarity"] = rarityReport;
+
+    // 检验 1：每个位置的稀有度分布
+    cout << "\n各位置的稀有度分布（卡方检验，显著性 0.1%）" << endl;
+    json positionReport = json::array();
+    for (size_t pos = 0; pos < slots && pos < h.rarityByPosition.size(); pos++) {
+        uint64_t n = 0;
+        for (int r = 0; r < 4; r++) n += h.rarityByPosition[pos][r];
+        double chi2 = 0;
+        int df = -1;
+        bool impossible = false;  // 出现了理论概率为 0 的稀有度
+        for (int r = 0; r < 4; r++) {
+            double e = expected[pos][r] * n;
+            if (e <= 0) {
+                impossible = impossible || h.rarityByPosition[pos][r] > 0;
+                continue;
+            }
+            chi2 += (h.rarityByPosition[pos][r] - e) * (h.rarityByPosition[pos][r] - e) / e;
+            df++;
+        }
+        bool passed = !impossible && (df <= 0 || chi2 < ShopTelemetry::chiSquareCritical(df));
+        allPassed = allPassed && passed;
+        cout << "  第 " << (pos + 1) << " 件: 卡方 " << setprecision(2) << chi2 << "，自由度 " << df;
+        if (df > 0) cout << "，临界值 " << ShopTelemetry::chiSquareCritical(df);
+        cout << (passed ? "  通过" : "  未通过") << endl;
+        positionReport.push_back({{"position", pos + 1}, {"chi2", chi2}, {"df", df}, {"passed", passed}});
+    }
+    report["positions"] = positionReport;
+
+    // 检验 2：同一稀有度内各模板的上架次数
+    cout << "\n同一稀有度内各模板的上架次数（卡方检验，显著性 0.1%）" << endl;
+    json templateReport = json::array();
+    for (int r = 0; r < 4; r++) {
+        const vector<Equipment*>& pool = profile->getCatalogue().pool(r);
+        if (pool.size() < 2 || h.rarity[r] == 0) continue;
+        double e = static_cast<double>(h.rarity[r]) / pool.size();
+        double chi2 = 0;
+        uint64_t lowest = UINT64_MAX, highest = 0;
+        for (Equipment* eq : pool) {
+            auto it = h.templates.find(eq->getId());
+            uint64_t count = it == h.templates.end() ? 0 : it->second;
+            chi2 += (count - e) * (count - e) / e;
+            lowest = min(lowest, count);
+            highest = max(highest, count);
+        }
+        int df = static_cast<int>(pool.size()) - 1;
+        bool passed = chi2 < ShopTelemetry::chiSquareCritical(df);
+        allPassed = allPassed && passed;
+        cout << "  " << left << setw(8) << RARITY_NAMES[r] << right << pool.size() << " 个模板，每个 "
+             << lowest << "-" << highest << " 次，卡方 " << setprecision(2) << chi2 << "，自由度 " << df
+             << "，临界值 " << ShopTelemetry::chiSquareCritical(df) << (passed ? "  通过" : "  未通过") << endl;
+        templateReport.push_back({{"rarity", RARITY_NAMES[r]}, {"templates", pool.size()}, {"min", lowest},
+                                  {"max", highest}, {"chi2", chi2}, {"df", df}, {"passed", passed}});
+    }
+    report["templates_uniform"] = templateReport;
+    report["passed"] = allPassed;
+
+    if (!opt.reportFile.empty()) {
+        ofstream out(opt.reportFile);
+        out << report.dump(2) << endl;
+        cout << "\n[系统] 统计结果已写入 " << opt.reportFile << endl;
+    }
+    cout << (allPassed ? "\n[系统] 全部检验通过。" : "\n[错误] 存在未通过的检验！") << endl;
+
+    for (auto eq : templates) delete eq;
+    return allPassed ? 0 : 1;
+}
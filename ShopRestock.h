@@ -0,0 +1,57 @@
+/**
+ * 文件名: ShopRestock.h
+ * 职责: 补货时钟 - 记录完成的冒险次数和战斗次数，连同现实时间作为商店补货的计时依据
+ *
+ * 商店只记录上次补货时的时钟读数，访问时才按经过的周期数补货（Shop::restock），
+ * 闲置的商店不需要随时钟逐个更新；错过多少个周期，补货都只计算一次。
+ * 冒险次数和战斗次数随商店状态一起保存在存档中，现实时间直接读取系统时间。
+ */
+
+#ifndef SHOP_RESTOCK_H
+#define SHOP_RESTOCK_H
+
+#include <ctime>
+#include <cstdint>
+#include "json.hpp"
+#include "ShopConfig.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+class RestockClock {
+private:
+    uint64_t adventures = 0;  // 完成的冒险次数
+    uint64_t battles = 0;     // 进行的战斗次数
+
+public:
+    // 时钟前进 count 个单位（现实时间自行流逝，不需要前进）
+    void advance(RestockUnit unit, uint64_t count = 1) {
+        if (unit == RestockUnit::ADVENTURE) adventures += count;
+        else if (unit == RestockUnit::BATTLE) battles += count;
+    }
+
+    // 按单位读取当前时钟
+    uint64_t now(RestockUnit unit) const {
+        switch (unit) {
+            case RestockUnit::ADVENTURE: return adventures;
+            case RestockUnit::BATTLE: return battles;
+            case RestockUnit::SECOND: return static_cast<uint64_t>(time(nullptr));
+        }
+        return 0;
+    }
+
+    json toJson() const {
+        json j;
+        j["adventures"] = adventures;
+        j["battles"] = battles;
+        return j;
+    }
+
+    // 旧存档没有时钟时从 0 开始
+    void fromJson(const json& j) {
+        adventures = j.is_object() ? j.value("adventures", static_cast<uint64_t>(0)) : 0;
+        battles = j.is_object() ? j.value("battles", static_cast<uint64_t>(0)) : 0;
+    }
+};
+
+#endif // SHOP_RESTOCK_H
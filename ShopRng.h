@@ -0,0 +1,69 @@
+/**
+ * 文件名: ShopRng.h
+ * 职责: 商店随机数 - 按 (种子, 刷新序号) 计数的随机数流
+ *
+ * 第 n 次刷新使用的随机数只由种子和 n 决定，与之前刷新过多少次、在哪个线程计算无关，
+ * 因此后台可以提前算好接下来几次刷新的结果，读档后也能得到相同的结果。
+ * 生成器为 SplitMix64，区间和小数的换算也在这里实现（不依赖标准库分布的实现细节），
+ * 同样的种子在不同编译器和平台上得到相同的商品。
+ * 每个商店的种子由存档槽位和商店 id 推导（seedFor），不同商店的刷新互不相关，同一槽位每次得到相同的种子。
+ */
+
+#ifndef SHOP_RNG_H
+#define SHOP_RNG_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+class ShopRng {
+private:
+    uint64_t state;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    // stream 为刷新序号：同一种子的不同序号得到互不相关的随机数流
+    ShopRng(uint64_t seed, uint64_t stream)
+        : state(mix(seed) ^ mix(stream * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL)) {}
+
+    // 由存档槽位和商店 id 推导种子（FNV-1a 后再混合一次），与时间无关
+    static uint64_t seedFor(const std::string& slot, const std::string& shopId) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        auto feed = [&h](const std::string& text) {
+            for (unsigned char c : text) {
+                h = (h ^ c) * 0x100000001b3ULL;
+            }
+            h = (h ^ 0xff) * 0x100000001b3ULL;  // 分隔符，避免 ("ab", "c") 与 ("a", "bc") 相同
+        };
+        feed(slot);
+        feed(shopId);
+        return mix(h);
+    }
+
+    uint64_t next() {
+        state += 0x9e3779b97f4a7c15ULL;
+        return mix(state);
+    }
+
+    // [0, n) 内的均匀整数（拒绝采样，无取模偏差），n 必须大于 0
+    uint64_t below(uint64_t n) {
+        uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+        uint64_t x;
+        do {
+            x = next();
+        } while (x >= limit);
+        return x % n;
+    }
+
+    // [0, 1) 内的均匀小数
+    double unit() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+#endif // SHOP_RNG_H
@@ -0,0 +1,96 @@
+/**
+ * 文件名: ShopRoller.h
+ * 职责: 后台商店计算线程 - 提前计算商店接下来几次刷新的商品
+ *
+ * 任务只读取共享的模板目录和抽取表，结果只由种子和刷新序号决定，
+ * 因此在后台什么时候算完都不影响结果。未调用 start() 时（例如命令行工具）任务直接在当前线程执行。
+ */
+
+#ifndef SHOP_ROLLER_H
+#define SHOP_ROLLER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+using namespace std;
+
+class ShopRoller {
+private:
+    thread worker;
+    mutex lock;
+    condition_variable wake;   // 有新任务或要求停止
+    deque<function<void()>> tasks;
+    bool running = false;
+    bool stopping = false;
+
+    static ShopRoller& instance() {
+        static ShopRoller r;
+        return r;
+    }
+
+    void run() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) break;  // stopping 且已无任务
+            function<void()> task = move(tasks.front());
+            tasks.pop_front();
+            guard.unlock();
+            task();
+            guard.lock();
+        }
+    }
+
+    ~ShopRoller() {
+        stop();
+    }
+
+public:
+    static void start() {
+        ShopRoller& r = instance();
+        lock_guard<mutex> guard(r.lock);
+        if (r.running) return;
+        r.stopping = false;
+        r.running = true;
+        r.worker = thread([&r]() { r.run(); });
+    }
+
+    // 提交计算任务，返回可多次读取的结果
+    template <class T>
+    static shared_future<T> submit(function<T()> job) {
+        auto task = make_shared<packaged_task<T()>>(move(job));
+        shared_future<T> result = task->get_future().share();
+        ShopRoller& r = instance();
+        {
+            lock_guard<mutex> guard(r.lock);
+            if (r.running) {
+                r.tasks.push_back([task]() { (*task)(); });
+                r.wake.notify_one();
+                return result;
+            }
+        }
+        (*task)();
+        return result;
+    }
+
+    // 算完剩余任务后结束线程
+    static void stop() {
+        ShopRoller& r = instance();
+        {
+            lock_guard<mutex> guard(r.lock);
+            if (!r.running) return;
+            r.stopping = true;
+            r.wake.notify_one();
+        }
+        r.worker.join();
+        lock_guard<mutex> guard(r.lock);
+        r.running = false;
+    }
+};
+
+#endif // SHOP_ROLLER_H
@@ -0,0 +1,110 @@
+/**
+ * 文件名: ShopTelemetry.h
+ * 职责: 商店抽取统计 - 按商店 id 记录刷新次数、各位置的稀有度分布和各模板上架次数
+ *
+ * 默认关闭，关闭时每次刷新只多一次原子读取。开启后（ShopHarness，或游戏启动参数 --shop-telemetry）
+ * 每次刷新在锁内累加一次，用来确认实际的稀有度分布是否与配置一致。
+ */
+
+#ifndef SHOP_TELEMETRY_H
+#define SHOP_TELEMETRY_H
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+class ShopTelemetry {
+public:
+    struct Histogram {
+        uint64_t refreshes = 0;
+        array<uint64_t, 4> rarity = {0, 0, 0, 0};     // 全部商品的稀有度，下标为 Rarity
+        vector<array<uint64_t, 4>> rarityByPosition;  // 第 i 件商品的稀有度
+        unordered_map<int, uint64_t> templates;       // 模板 id -> 上架次数
+    };
+
+    static void enable(bool on) {
+        flag().store(on, memory_order_relaxed);
+    }
+
+    static bool enabled() {
+        return flag().load(memory_order_relaxed);
+    }
+
+    // 记录一次刷新；offers 的元素需要有 templateId 和 rarity（ShopOffer）
+    template <class Offers>
+    static void record(const string& shopId, const Offers& offers) {
+        lock_guard<mutex> guard(lock());
+        Histogram& h = table()[shopId];
+        h.refreshes++;
+        if (h.rarityByPosition.size() < offers.size()) h.rarityByPosition.resize(offers.size(), {0, 0, 0, 0});
+        size_t pos = 0;
+        for (const auto& offer : offers) {
+            int r = static_cast<int>(offer.rarity);
+            h.rarity[r]++;
+            h.rarityByPosition[pos++][r]++;
+            h.templates[offer.templateId]++;
+        }
+    }
+
+    static map<string, Histogram> snapshot() {
+        lock_guard<mutex> guard(lock());
+        return table();
+    }
+
+    static void reset() {
+        lock_guard<mutex> guard(lock());
+        table().clear();
+    }
+
+    // 简要报告：各商店的刷新次数和稀有度占比（在本地字符串流中格式化，不改动 out 的格式设置）
+    static void print(ostream& out) {
+        static const char* names[4] = {"损坏", "普通", "军用", "传奇"};
+        for (const auto& entry : snapshot()) {
+            const Histogram& h = entry.second;
+            uint64_t total = h.rarity[0] + h.rarity[1] + h.rarity[2] + h.rarity[3];
+            ostringstream line;
+            line << "[统计] 商店 " << entry.first << ": 刷新 " << h.refreshes << " 次，上架 " << total << " 件";
+            line << fixed << setprecision(1);
+            for (int r = 0; r < 4; r++) {
+                line << "，" << names[r] << " " << (total ? 100.0 * h.rarity[r] / total : 0.0) << "%";
+            }
+            out << line.str() << endl;
+        }
+    }
+
+    // 卡方分布上侧 0.1% 临界值（Wilson-Hilferty 近似）
+    static double chiSquareCritical(int df) {
+        const double z = 3.090;
+        double a = 2.0 / (9.0 * df);
+        return df * pow(1 - a + z * sqrt(a), 3);
+    }
+
+private:
+    static atomic<bool>& flag() {
+        static atomic<bool> on(false);
+        return on;
+    }
+
+    static mutex& lock() {
+        static mutex m;
+        return m;
+    }
+
+    static map<string, Histogram>& table() {
+        static map<string, Histogram> t;
+        return t;
+    }
+};
+
+#endif // SHOP_TELEMETRY_H
@@ -0,0 +1,100 @@
+/**
+ * 文件名: SlotMeta.h
+ * 职责: 存档槽位元数据 - 每个槽位旁边的小文件 saves/save_slot_<槽位名>.meta
+ *
+ * 内容（几十字节的 JSON）:
+ * {"player_name":"Bob","exp":480,"item_count":6,"saved_at":1760000000,
+ *  "format":"json","snapshot_size":1834,"checksum":3735928559}
+ * 每次保存（完整快照或追加日志）后更新。存档菜单只读取元数据，
+ * 启动校验只比较快照文件的大小和 CRC32C，不再解析存档内容。
+ */
+
+#ifndef SLOT_META_H
+#define SLOT_META_H
+
+#include <string>
+#include <ctime>
+#include <cstdint>
+#include "json.hpp"
+#include "SaveIO.h"
+#include "SaveFormat.h"
+#include "Checksum.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+struct SlotMeta {
+    string playerName;
+    int exp = 0;
+    int itemCount = 0;
+    long long savedAt = 0;       // 最后保存时间（Unix 时间戳）
+    SaveFormat format = SaveFormat::JSON;
+    size_t snapshotSize = 0;     // 快照文件字节数
+    uint32_t checksum = 0;       // 快照文件的 CRC32C
+
+    static string metaPath(const string& slotName) {
+        return "saves/save_slot_" + slotName + ".meta";
+    }
+
+    // 记录快照文件的大小和校验和
+    void setSnapshot(const string& data) {
+        setSnapshot(data.size(), Checksum::crc32c(data));
+    }
+
+    void setSnapshot(size_t size, uint32_t crc) {
+        snapshotSize = size;
+        checksum = crc;
+    }
+
+    // 快照文件内容与元数据记录的一致（未损坏、未被外部修改）
+    bool matchesSnapshot(size_t size, uint32_t crc) const {
+        return size == snapshotSize && crc == checksum;
+    }
+
+    // 分块读取快照文件校验，不把整个文件读入内存
+    bool matchesFile(const string& path) const {
+        size_t size;
+        uint32_t crc;
+        return Checksum::crc32cFile(path, size, crc) && matchesSnapshot(size, crc);
+    }
+
+    bool write(const string& slotName) const {
+        json j;
+        j["player_name"] = playerName;
+        j["exp"] = exp;
+        j["item_count"] = itemCount;
+        j["saved_at"] = savedAt;
+        j["format"] = format == SaveFormat::MSGPACK ? "msgpack" : "json";
+        j["snapshot_size"] = snapshotSize;
+        j["checksum"] = checksum;
+        return SaveIO::atomicWrite(metaPath(slotName), j.dump());
+    }
+
+    // 元数据不存在或无法解析时返回 false
+    static bool read(const string& slotName, SlotMeta& meta) {
+        string data;
+        if (!SaveIO::readFile(metaPath(slotName), data)) return false;
+        json j = json::parse(data, nullptr, false);
+        if (j.is_discarded() || !j.is_object() || !j.contains("checksum")) return false;
+
+        meta.playerName = j.value("player_name", "");
+        meta.exp = j.value("exp", 0);
+        meta.itemCount = j.value("item_count", 0);
+        meta.savedAt = j.value("saved_at", 0LL);
+        meta.format = j.value("format", "json") == "msgpack" ? SaveFormat::MSGPACK : SaveFormat::JSON;
+        meta.snapshotSize = j.value("snapshot_size", static_cast<size_t>(0));
+        meta.checksum = j.value("checksum", 0u);
+        return true;
+    }
+
+    // 显示用的保存时间，例如 "2025-12-28 21:05"
+    string savedAtText() const {
+        if (savedAt == 0) return "";
+        time_t t = static_cast<time_t>(savedAt);
+        char buffer[32];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", localtime(&t));
+        return buffer;
+    }
+};
+
+#endif // SLOT_META_H
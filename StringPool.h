@@ -0,0 +1,77 @@
+/**
+ * 文件名: StringPool.h
+ * 职责: 字符串池 - 名称、势力等内容字符串只存一份，其他地方通过 string_view 引用
+ *
+ * 字符串按加载顺序紧密存放在大块连续内存中；块写满后才分配新块，
+ * 已有字符串的地址永远不变，因此返回的 string_view 在程序运行期间一直有效。
+ */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <cstring>
+
+using namespace std;
+
+class StringPool {
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    vector<unique_ptr<char[]>> blocks;  // 连续存储块
+    size_t used = BLOCK_SIZE;           // 当前块已用字节（初始视为已满）
+    size_t totalBytes = 0;
+    unordered_set<string_view> index;   // 去重索引，指向块内的数据
+    mutex lock;                         // 内容包会在工作线程中加载
+
+    static StringPool& instance() {
+        static StringPool pool;
+        return pool;
+    }
+
+    string_view store(string_view s) {
+        if (s.size() > BLOCK_SIZE) {
+            // 超长字符串单独占一块，不影响当前块的剩余空间
+            blocks.emplace_back(new char[s.size()]);
+            memcpy(blocks.back().get(), s.data(), s.size());
+            totalBytes += s.size();
+            return string_view(blocks.back().get(), s.size());
+        }
+        if (used + s.size() > BLOCK_SIZE) {
+            blocks.emplace_back(new char[BLOCK_SIZE]);
+            used = 0;
+        }
+        char* dst = blocks.back().get() + used;
+        memcpy(dst, s.data(), s.size());
+        used += s.size();
+        totalBytes += s.size();
+        return string_view(dst, s.size());
+    }
+
+public:
+    // 返回池中与 s 内容相同的字符串（不存在则复制进池）
+    static string_view intern(string_view s) {
+        if (s.empty()) return string_view();
+        StringPool& pool = instance();
+        lock_guard<mutex> guard(pool.lock);
+        auto it = pool.index.find(s);
+        if (it != pool.index.end()) return *it;
+        string_view stored = pool.store(s);
+        pool.index.insert(stored);
+        return stored;
+    }
+
+    // 池中字符串的总字节数（用于调试显示）
+    static size_t bytesUsed() {
+        StringPool& pool = instance();
+        lock_guard<mutex> guard(pool.lock);
+        return pool.totalBytes;
+    }
+};
+
+#endif // STRING_POOL_H
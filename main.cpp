@@ -94,6 +94,8 @@ public:
         cout << "[5] 访问商店 (Shop)" << endl;
         cout << "[6] 装备合并 (Merge)" << endl;
         cout << "[7] 手动存档 (Save)" << endl;
+        cout << "[8] 存档格式 (Save Format)" << endl;
+        cout << "[9] 存档历史 (History)" << endl;
         // cout << "[9] 测试：获得100 EXP" << endl;  // 测试用
         // cout << "[8] 查看怪物图鉴 (Bestiary)" << endl;  // 暂时隐藏
         cout << "[0] 退出系统 (Exit)" << endl;
@@ -148,79 +150,174 @@ const string Display::COLOR_YELLOW = "\033[33m";
 // ==========================================
 // [商店状态管理] Shop State Functions
 // ==========================================
-void saveShopStates(int slotIndex, Shop& baseShop, Shop& campfireShop) {
+// 商店状态很小（每个商店 3 件商品），与玩家数据一起保存在槽位存档中
+// 补货时钟（冒险次数、战斗次数）与商店状态保存在一起
+json shopStates(const Shop& baseShop, const Shop& campfireShop, const RestockClock& restockClock) {
     json shopJson;
     shopJson["base_shop"] = baseShop.toJson();
     shopJson["campfire_shop"] = campfireShop.toJson();
-    
-    string filename = "saves/shop_slot_" + to_string(slotIndex) + ".json";
-    ofstream f(filename);
-    if (f.is_open()) {
-        f << shopJson.dump(4);
-        cout << "[存档] 商店状态已保存。" << endl;
-    }
+    shopJson["restock_clock"] = restockClock.toJson();
+    return shopJson;
 }
 
-void loadShopStates(int slotIndex, Shop& baseShop, Shop& campfireShop, const vector<Equipment*>& templates) {
-    string filename = "saves/shop_slot_" + to_string(slotIndex) + ".json";
-    ifstream f(filename);
-    
-    if (!f.is_open()) {
+// slot: 存档槽位，用于推导各商店的随机数种子（存档中已有种子时以存档为准）
+// shopJson: 读档得到的商店状态，为 null 表示存档中没有商店数据
+void loadShopStates(const string& slot, const json& shopJson, Shop& baseShop, Shop& campfireShop,
+                    RestockClock& restockClock) {
+    baseShop.setSeed(ShopRng::seedFor(slot, baseShop.getProfile()->getConfig().id));
+    campfireShop.setSeed(ShopRng::seedFor(slot, campfireShop.getProfile()->getConfig().id));
+    restockClock.fromJson(shopJson.is_object() && shopJson.contains("restock_clock") ? shopJson["restock_clock"] : json());
+
+    if (!shopJson.is_object()) {
         // 如果没有商店存档，初始化为新商店
         cout << "[系统] 商店存档不存在，正在初始化新商店。" << endl;
-        baseShop.refresh();
+        baseShop.markNeedsRefresh();  // 首次访问时再刷新，避免启动时加载全部装备
         return;
     }
     
     try {
-        json shopJson = json::parse(f);
-        f.close();
-        
         if (shopJson.contains("base_shop")) {
-            baseShop.fromJson(shopJson["base_shop"], templates);
+            baseShop.fromJson(shopJson["base_shop"], SaveManager::getItemTemplate);
         } else {
             cout << "[警告] 基地商店数据缺失，正在重新初始化。" << endl;
-            baseShop.refresh();
+            baseShop.markNeedsRefresh();
         }
         
         if (shopJson.contains("campfire_shop")) {
-            campfireShop.fromJson(shopJson["campfire_shop"], templates);
+            campfireShop.fromJson(shopJson["campfire_shop"], SaveManager::getItemTemplate);
         } else {
             cout << "[提示] 篝火商店数据缺失，将在首次冒险时初始化。" << endl;
         }
         
         cout << "[存档] 商店状态已恢复。" << endl;
-    } catch (json::parse_error& e) {
-        f.close();
-        cout << "[警告] 商店存档损坏（JSON 解析失败），正在重新初始化。" << endl;
-        cout << "[详细] " << e.what() << endl;
-        baseShop.refresh();
     } catch (...) {
-        f.close();
         cout << "[警告] 商店存档读取失败，正在重新初始化。" << endl;
-        baseShop.refresh();
+        baseShop.markNeedsRefresh();
+    }
+}
+
+// 按存档中的装备 id 恢复装备配置
+void restoreEquipment(EquipmentSlot& equipSlot, const vector<Equipment*>& inventory,
+                      int equippedArmorId, const vector<int>& equippedWeaponIds) {
+    if (equippedArmorId != -1) {
+        for (auto item : inventory) {
+            if (item->getId() == equippedArmorId) {
+                equipSlot.equippedArmor = dynamic_cast<Armor*>(item);
+                cout << "[存档] 已恢复装备的装甲: " << item->getName() << endl;
+                break;
+            }
+        }
+    }
+    
+    for (int weaponId : equippedWeaponIds) {
+        for (auto item : inventory) {
+            if (item->getId() == weaponId) {
+                Weapon* weapon = dynamic_cast<Weapon*>(item);
+                if (weapon) {
+                    equipSlot.equippedWeapons.push_back(weapon);
+                    cout << "[存档] 已恢复装备的武器: " << item->getName() << endl;
+                }
+                break;
+            }
+        }
+    }
+}
+
+// 列出当前槽位的存档历史（新的在前），返回全部条目（旧 -> 新）
+vector<SaveHistory::Entry> showSaveHistory(const string& slot) {
+    vector<SaveHistory::Entry> entries = SaveHistory::list(slot);
+    cout << "\n=== 存档历史 (槽位 " << slot << "，共 " << entries.size() << " 条) ===" << endl;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        cout << "[#" << it->id << "] " << SaveHistory::timeText(it->savedAt) << " " << it->label
+             << " | " << it->playerName << " (EXP: " << it->exp << ", 装备: " << it->itemCount << "件)" << endl;
+    }
+    if (entries.empty()) {
+        cout << "暂无历史记录。手动存档、退出游戏、有失败可能的升级和装备合并之前会自动记录。" << endl;
+    }
+    cout << "===================" << endl;
+    return entries;
+}
+
+// 存档选择菜单：分页列出 saves 文件夹中的所有槽位，输入槽位名选择，输入新名字则创建新槽位
+// 返回空字符串表示输入已结束
+string selectSaveSlot() {
+    vector<string> slots = SaveManager::listSlots();
+    int pageSize = SaveManager::SLOT_PAGE_SIZE;
+    int pageCount = max(1, static_cast<int>((slots.size() + pageSize - 1) / pageSize));
+    int page = 0;
+
+    while (true) {
+        SaveManager::showSaveSlots(slots, page);
+        cout << "\n请输入存档槽位名（输入新名字创建新存档";
+        if (pageCount > 1) cout << "，n 下一页，p 上一页";
+        cout << "）: ";
+
+        string input;
+        if (!(cin >> input)) {
+            return "";
+        }
+        if (input == "n" || input == "p") {
+            page = input == "n" ? min(page + 1, pageCount - 1) : max(page - 1, 0);
+            system("cls");
+            continue;
+        }
+        if (!SaveManager::isValidSlotName(input)) {
+            cout << "[错误] 槽位名只能包含英文字母、数字、下划线和减号（最长 64 个字符）。" << endl;
+            continue;
+        }
+        return input;
     }
 }
 
 // ==========================================
 // [主程序] Main Function
 // ==========================================
-int main() {
+int main(int argc, char* argv[]) {
     // 1. 环境初始化
     // Windows下强制使用UTF-8编码，防止中文乱码
     system("chcp 65001"); 
+
+#ifdef EMBEDDED_CONTENT
+    // 内嵌构建自检：比较内嵌表和 gamedata.json 的加载结果
+    if (argc > 1 && string(argv[1]) == "--verify-content") {
+        return SaveManager::verifyEmbeddedContent("gamedata.json") ? 0 : 1;
+    }
+#else
+    // 内容包自检：按不同顺序加载内容包，结果必须相同
+    if (argc > 1 && string(argv[1]) == "--verify-content") {
+        return SaveManager::verifyContentPacks("content/manifest.json") ? 0 : 1;
+    }
+#endif
+
     system("cls"); // 清屏
     
     // 初始化游戏数据和存档槽位
-    SaveManager::initGameData("gamedata.json");
+#ifdef EMBEDDED_CONTENT
+    SaveManager::initEmbeddedGameData();  // 内嵌内容，无文件 I/O
+#else
+    SaveManager::initContent("content/manifest.json", "gamedata.json");
+    ShopConfigs::load("shops.json");
+    // 服务器部署：启动时一次性并行加载所有内容包
+    if (argc > 1 && string(argv[1]) == "--preload-content") {
+        SaveManager::preloadContent();
+    }
+#endif
+    // 记录商店抽取统计，退出时输出（用于确认实际的稀有度分布）
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--shop-telemetry") ShopTelemetry::enable(true);
+    }
     SaveManager::initializeSaveSlots();
     
-    // 显示存档槽位信息
-    SaveManager::showSaveSlots();
-    
-    int slot = 0;
-    cout << "\n请选择存档槽位 (1-3): ";
-    cin >> slot;
+    // 显示存档槽位信息并选择槽位
+    string slot = selectSaveSlot();
+    if (slot.empty()) {
+        return 0;
+    }
+    SaveManager::prepareSlot(slot);
+    // 之后的存档写入都在后台线程中进行
+    SaveWorker::start();
+    // 商店接下来几次刷新的商品在后台提前计算
+    ShopRoller::start();
 
     string playerName = "User";
     int playerExp = 0;
@@ -228,7 +325,8 @@ int main() {
     vector<int> equippedWeaponIds;
     
     // 尝试加载存档
-    vector<Equipment*> inventory = SaveManager::loadSave(slot, playerName, playerExp, equippedArmorId, equippedWeaponIds);
+    json savedShops;
+    vector<Equipment*> inventory = SaveManager::loadSave(slot, playerName, playerExp, equippedArmorId, equippedWeaponIds, savedShops);
 
     // 如果是空背包（说明是新存档），给个初始装备
     if (inventory.empty()) {
@@ -262,42 +360,30 @@ int main() {
     Sleep(1000);
     system("cls");
     // 2. 数据加载 (Data Loading)
-    // 加载怪物数据用于图鉴显示
-    vector<Monster> monsters = DataLoader::loadMonsters("gamedata.json");
+    // 怪物数据在出发冒险时按难度获取（使用内容包时按需加载）
     
     // 初始化装备槽
     EquipmentSlot equipSlot;
     
-    // 初始化基地商店和篝火商店
-    vector<Equipment*> allEquipmentTemplates = SaveManager::getAllEquipmentTemplates();
-    Shop baseShop(allEquipmentTemplates);
-    Shop campfireShop(allEquipmentTemplates);
+    // 初始化基地商店和篝火商店：共用一份模板目录（装备模板在第一次刷新时才加载）
+    shared_ptr<const ShopCatalogue> shopCatalogue = ShopCatalogue::fromSource(SaveManager::getAllEquipmentTemplates);
+    shared_ptr<const ShopProfile> baseShopProfile = ShopProfile::create(shopCatalogue, ShopConfigs::get("base"));
+    shared_ptr<const ShopProfile> campfireShopProfile = ShopProfile::create(shopCatalogue, ShopConfigs::get("campfire"));
+    Shop baseShop(baseShopProfile);
+    Shop campfireShop(campfireShopProfile);
+    RestockClock restockClock;  // 补货时钟（读档时恢复）
     
     // 加载商店状态
-    loadShopStates(slot, baseShop, campfireShop, allEquipmentTemplates);
+    loadShopStates(slot, savedShops, baseShop, campfireShop, restockClock);
     
     // 恢复装备配置
-    if (equippedArmorId != -1) {
-        for (auto item : inventory) {
-            if (item->getId() == equippedArmorId) {
-                equipSlot.equippedArmor = dynamic_cast<Armor*>(item);
-                cout << "[存档] 已恢复装备的装甲: " << item->getName() << endl;
-                break;
-            }
-        }
-    }
-    
-    for (int weaponId : equippedWeaponIds) {
-        for (auto item : inventory) {
-            if (item->getId() == weaponId) {
-                Weapon* weapon = dynamic_cast<Weapon*>(item);
-                if (weapon) {
-                    equipSlot.equippedWeapons.push_back(weapon);
-                    cout << "[存档] 已恢复装备的武器: " << item->getName() << endl;
-                }
-                break;
-            }
-        }
+    restoreEquipment(equipSlot, inventory, equippedArmorId, equippedWeaponIds);
+
+    // 新存档（或改名）在这里写入第一个完整快照，老存档没有变化则不写盘
+    {
+        vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+        SaveManager::recordChanges(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec,
+                                   shopStates(baseShop, campfireShop, restockClock));
     }
 
     // 3. 游戏主循环 (Game Loop)
@@ -321,9 +407,11 @@ int main() {
                 isRunning = false;
                 // 保存游戏，包括装备配置
                 vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
-                SaveManager::saveGame(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec);
-                // 保存商店状态
-                saveShopStates(slot, baseShop, campfireShop);
+                SaveManager::saveGame(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec,
+                                      shopStates(baseShop, campfireShop, restockClock), "退出游戏");
+                // 先等后台商店计算结束（队列中的任务仍会读取装备模板），再等后台写完，最后释放模板
+                ShopRoller::stop();
+                SaveWorker::flush();
                 SaveManager::cleanUp();
                 cout << "正在将意识上传至云端..."<<endl;
                 cout << "正在断开神经连接... 再见！" << endl;
@@ -633,6 +721,10 @@ int main() {
                                 // 显示升级成功率
                                 if (successRate < 100) {
                                     cout << "\n[提示] 该装备升级成功率: " << successRate << "%" << endl;
+                                    // 升级可能失败：先记录存档历史，失败后可以在 [9] 存档历史 中回滚
+                                    vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+                                    SaveManager::checkpoint(slot, string("升级前: ").append(selectedWeapon->getName()), playerName, inventory, playerExp,
+                                                            equipSlot.equippedArmor, equippedWeaponsVec, shopStates(baseShop, campfireShop, restockClock));
                                 }
                                 
                                 playerExp -= cost;
@@ -642,6 +734,8 @@ int main() {
                                 bool success = selectedWeapon->levelUp();
                                 
                                 if (success) {
+                                    SaveManager::noteItemLevelChanged(
+                                        find(inventory.begin(), inventory.end(), selectedWeapon) - inventory.begin());
                                     cout << "\n★ 升级成功！ ★" << endl;
                                     cout << Display::getRarityColor(selectedWeapon->getRarity()) 
                                          << selectedWeapon->getName() << Display::COLOR_RESET 
@@ -676,6 +770,10 @@ int main() {
                                 // 显示升级成功率
                                 if (successRate < 100) {
                                     cout << "\n[提示] 该装备升级成功率: " << successRate << "%" << endl;
+                                    // 升级可能失败：先记录存档历史，失败后可以在 [9] 存档历史 中回滚
+                                    vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+                                    SaveManager::checkpoint(slot, string("升级前: ").append(selectedArmor->getName()), playerName, inventory, playerExp,
+                                                            equipSlot.equippedArmor, equippedWeaponsVec, shopStates(baseShop, campfireShop, restockClock));
                                 }
                                 
                                 playerExp -= cost;
@@ -685,6 +783,8 @@ int main() {
                                 bool success = selectedArmor->levelUp();
                                 
                                 if (success) {
+                                    SaveManager::noteItemLevelChanged(
+                                        find(inventory.begin(), inventory.end(), selectedArmor) - inventory.begin());
                                     cout << "\n★ 升级成功！ ★" << endl;
                                     cout << Display::getRarityColor(selectedArmor->getRarity()) 
                                          << selectedArmor->getName() << Display::COLOR_RESET 
@@ -739,11 +839,15 @@ int main() {
                 }
                 
                 // 开始冒险
-                AdventureSystem adventure(monsters, &equipSlot, playerExp, &campfireShop);
+                AdventureSystem adventure(SaveManager::getMonstersForDifficulty(0), &equipSlot, playerExp,
+                                          &campfireShop, SaveManager::getMonstersForDifficulty, &restockClock);
                 adventure.startAdventure(inventory);
+                for (size_t idx : adventure.getUpgradedItems()) {
+                    SaveManager::noteItemLevelChanged(idx);
+                }
                 
-                // 冒险结束后，标记基地商店需要刷新
-                baseShop.markNeedsRefresh();
+                // 冒险结束后补货时钟前进一次冒险，基地商店和篝火商店在下次访问时按配置补货
+                restockClock.advance(RestockUnit::ADVENTURE);
                 break;
             }
             
@@ -752,16 +856,17 @@ int main() {
                 system("cls");
                 cout << "\n=== 基地商店 ===" << endl;
                 
-                // 如果需要刷新，刷新商店
-                if (baseShop.isNeedsRefresh()) {
-                    baseShop.refresh();
-                }
+                // 按补货时钟补货（错过多个周期时只刷新一次）
+                baseShop.restock(restockClock);
                 
                 while (true) {
                     cout << "\n";
                     baseShop.display();
                     cout << "\n当前 EXP: " << playerExp << endl;
-                    cout << "\n[1-3] 购买对应商品 | [4] 手动刷新 (" << baseShop.getManualRefreshCost() << " EXP) | [0] 返回主菜单" << endl;
+                    int slotCount = baseShop.getSlotCount();
+                    cout << "\n[1-" << slotCount << "] 购买对应商品 | [" << (slotCount + 1) << "] 手动刷新 ("
+                         << baseShop.getManualRefreshCost() << " EXP) | [" << (slotCount + 2)
+                         << "] 批量购买 | [0] 返回主菜单" << endl;
                     cout << ">>> 请选择: ";
                     
                     int shopChoice;
@@ -769,14 +874,14 @@ int main() {
                     
                     if (shopChoice == 0) {
                         break;
-                    } else if (shopChoice >= 1 && shopChoice <= 3) {
+                    } else if (shopChoice >= 1 && shopChoice <= slotCount) {
                         if (baseShop.buyItem(shopChoice - 1, playerExp, inventory)) {
                             cout << "\n[提示] 装备已添加到背包！" << endl;
                         }
                         system("pause");
                         system("cls");
                         cout << "\n=== 基地商店 ===" << endl;
-                    } else if (shopChoice == 4) {
+                    } else if (shopChoice == slotCount + 1) {
                         // 手动刷新
                         if (baseShop.manualRefresh(playerExp)) {
                             cout << "\n商店已刷新！" << endl;
@@ -784,6 +889,15 @@ int main() {
                         system("pause");
                         system("cls");
                         cout << "\n=== 基地商店 ===" << endl;
+                    } else if (shopChoice == slotCount + 2) {
+                        // 批量购买：一次选好几件，总价一次结算，只刷新一次界面
+                        vector<int> picks = Shop::readSelection(cin);
+                        if (!picks.empty() && baseShop.buyItems(picks, playerExp, inventory)) {
+                            cout << "\n[提示] 装备已添加到背包！" << endl;
+                        }
+                        system("pause");
+                        system("cls");
+                        cout << "\n=== 基地商店 ===" << endl;
                 } else {
                         cout << "无效选项！" << endl;
                     }
@@ -938,22 +1052,28 @@ int main() {
                     break;
                 }
                 
+                // 合并会删除两件装备：先记录存档历史，之后可以在 [9] 存档历史 中回滚
+                {
+                    vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+                    string label = string("合并前: ").append(eq1->getName()).append(" + ").append(eq2->getName());
+                    SaveManager::checkpoint(slot, label, playerName, inventory, playerExp,
+                                            equipSlot.equippedArmor, equippedWeaponsVec, shopStates(baseShop, campfireShop, restockClock));
+                }
+
                 // 执行合并
                 cout << "\n正在合并装备..." << endl;
                 
                 // 从该势力的装备中随机选择一个
                 vector<Equipment*> factionEquipment;
-                vector<Equipment*> allTemplates = SaveManager::getAllEquipmentTemplates();
+                vector<Equipment*> allTemplates = SaveManager::getEquipmentTemplatesByFaction(eq1->getFaction());
                 
                 for (auto tmpl : allTemplates) {
-                    if (tmpl->getFaction() == eq1->getFaction()) {
-                        // 检查类型匹配
-                        Weapon* tw = dynamic_cast<Weapon*>(tmpl);
-                        Armor* ta = dynamic_cast<Armor*>(tmpl);
-                        
-                        if ((w1 && tw) || (a1 && ta)) {
-                            factionEquipment.push_back(tmpl);
-                        }
+                    // 检查类型匹配
+                    Weapon* tw = dynamic_cast<Weapon*>(tmpl);
+                    Armor* ta = dynamic_cast<Armor*>(tmpl);
+                    
+                    if ((w1 && tw) || (a1 && ta)) {
+                        factionEquipment.push_back(tmpl);
                     }
                 }
                 
@@ -999,9 +1119,13 @@ int main() {
                 }
                 
                 if (newEquipment) {
-                    // 从背包中移除两件旧装备
-                    inventory.erase(remove(inventory.begin(), inventory.end(), eq1), inventory.end());
-                    inventory.erase(remove(inventory.begin(), inventory.end(), eq2), inventory.end());
+                    // 从背包中移除两件旧装备（报告移除位置，保存时只比较变化的装备）
+                    for (Equipment* old : {eq1, eq2}) {
+                        auto it = find(inventory.begin(), inventory.end(), old);
+                        if (it == inventory.end()) continue;
+                        SaveManager::noteItemRemoved(it - inventory.begin());
+                        inventory.erase(it);
+                    }
                     
                     // 删除旧装备
                     delete eq1;
@@ -1028,14 +1152,97 @@ int main() {
                 cout << "\n=== 手动存档 ===" << endl;
                 cout << "正在保存游戏进度..." << endl;
                 vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
-                SaveManager::saveGame(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec);
-                // 保存商店状态
-                saveShopStates(slot, baseShop, campfireShop);
+                SaveManager::saveGame(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec,
+                                      shopStates(baseShop, campfireShop, restockClock));
                 cout << "存档完成！" << endl;
                 system("pause");
                 break;
             }
             
+            case 8: // 切换当前槽位的存档格式
+            {
+                cout << "\n=== 存档格式 ===" << endl;
+                cout << "当前格式: " << SaveCodec::formatName(SaveManager::getSlotFormat()) << endl;
+                cout << "[1] JSON 文本（可手动查看和修改）" << endl;
+                cout << "[2] 二进制 MessagePack（体积小，读写快，适合大背包）" << endl;
+                cout << "[0] 返回" << endl;
+                cout << ">>> 请选择: ";
+                int formatChoice;
+                cin >> formatChoice;
+                if (formatChoice == 1 || formatChoice == 2) {
+                    SaveFormat format = formatChoice == 1 ? SaveFormat::JSON : SaveFormat::MSGPACK;
+                    if (format != SaveManager::getSlotFormat()) {
+                        SaveManager::setSlotFormat(format);
+                        // 立即以新格式写入完整快照，读档时会自动识别
+                        vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+                        SaveManager::saveGame(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec,
+                                              shopStates(baseShop, campfireShop, restockClock), "切换存档格式");
+                    }
+                    cout << "存档格式: " << SaveCodec::formatName(format) << endl;
+                }
+                system("pause");
+                break;
+            }
+
+            case 9: // 存档历史：回滚到之前的快照
+            {
+                // 等后台把已提交的快照写完，列表才是最新的
+                SaveWorker::flush();
+                vector<SaveHistory::Entry> history = showSaveHistory(slot);
+                if (history.empty()) {
+                    system("pause");
+                    break;
+                }
+                cout << "输入要回滚到的记录编号（输入 0 返回）: ";
+                int historyId;
+                cin >> historyId;
+                if (historyId == 0) break;
+                auto target = find_if(history.begin(), history.end(),
+                                      [historyId](const SaveHistory::Entry& e) { return e.id == historyId; });
+                if (target == history.end()) {
+                    cout << "没有编号为 #" << historyId << " 的记录。" << endl;
+                    system("pause");
+                    break;
+                }
+                SaveHistory::Entry entry = *target;
+                cout << "回滚到 [#" << entry.id << "] " << entry.label << "（" << SaveHistory::timeText(entry.savedAt)
+                     << "），当前进度会先记录为一条新历史。确认？(1=是, 0=否): ";
+                int confirm;
+                cin >> confirm;
+                if (confirm != 1) {
+                    cout << "已取消回滚。" << endl;
+                    system("pause");
+                    break;
+                }
+
+                // 先记录当前进度，回滚本身也可以撤销
+                // （历史已满且要回滚到最旧的一条时不记录，否则新记录会把目标挤出历史）
+                if (history.size() < SaveHistory::MAX_ENTRIES || target != history.begin()) {
+                    vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+                    SaveManager::checkpoint(slot, "回滚前", playerName, inventory, playerExp,
+                                            equipSlot.equippedArmor, equippedWeaponsVec, shopStates(baseShop, campfireShop, restockClock));
+                }
+                string error;
+                if (!SaveManager::restoreHistory(slot, historyId, error)) {
+                    cout << "[错误] 回滚失败（" << error << "），当前存档保持不变。" << endl;
+                    system("pause");
+                    break;
+                }
+
+                // 重新读档，替换内存中的玩家、装备和商店状态
+                for (auto item : inventory) delete item;
+                equipSlot.equippedArmor = nullptr;
+                equipSlot.equippedWeapons.clear();
+                inventory = SaveManager::loadSave(slot, playerName, playerExp, equippedArmorId, equippedWeaponIds, savedShops);
+                restoreEquipment(equipSlot, inventory, equippedArmorId, equippedWeaponIds);
+                baseShop = Shop(baseShopProfile);
+                campfireShop = Shop(campfireShopProfile);
+                loadShopStates(slot, savedShops, baseShop, campfireShop, restockClock);
+                cout << "[存档] 已回滚到 [#" << entry.id << "] " << entry.label << endl;
+                system("pause");
+                break;
+            }
+
             case -114: // 测试：获得EXP
                 playerExp += 1000;
                 cout << "获得 1000 EXP！当前 EXP: " << playerExp << endl;
@@ -1050,6 +1257,13 @@ int main() {
                 break;
         }
         
+        // 每次操作后把玩家和商店的变化一起追加到存档日志，崩溃时最多丢失当前这一步
+        if (isRunning) {
+            vector<Equipment*> equippedWeaponsVec(equipSlot.equippedWeapons.begin(), equipSlot.equippedWeapons.end());
+            SaveManager::recordChanges(slot, playerName, inventory, playerExp, equipSlot.equippedArmor, equippedWeaponsVec,
+                                       shopStates(baseShop, campfireShop, restockClock));
+        }
+
         // 每次操作完清屏一次，保持界面整洁 (可选)
         system("cls"); 
     }
@@ -1061,5 +1275,7 @@ int main() {
     }
     inventory.clear();
 
+    if (ShopTelemetry::enabled()) ShopTelemetry::print(cout);
+    SaveWorker::stop();
     return 0;
 }
\ No newline at end of file